@@ -0,0 +1,84 @@
+#include <jarngreipr/geometry/min_distance.hpp>
+#include <iostream>
+#include <random>
+#include <chrono>
+
+// compare the bead-bead contact test using the SIMD kernel with early exit
+// against the full distance_sq loop that was used before.
+//
+// usage: bench_min_distance [number of pairs]
+
+using coordinate_type = mjolnir::math::Vector<double, 3>;
+
+std::vector<coordinate_type>
+make_residue(std::mt19937& mt, const coordinate_type& center, const std::size_t n)
+{
+    std::uniform_real_distribution<double> uni(-2.0, 2.0);
+    std::vector<coordinate_type> atoms;
+    for(std::size_t i=0; i<n; ++i)
+    {
+        atoms.push_back(center + coordinate_type(uni(mt), uni(mt), uni(mt)));
+    }
+    return atoms;
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t num_pairs = (argc > 1) ? std::stoul(argv[1]) : 1000000;
+    const double threshold_sq = 6.5 * 6.5;
+
+    std::mt19937 mt(123456789);
+    std::uniform_int_distribution<std::size_t> natoms(4, 14);
+    std::uniform_real_distribution<double>     dist(0.0, 20.0);
+
+    // make pairs of residue-like clusters at various separations
+    std::vector<std::pair<std::vector<coordinate_type>,
+                          std::vector<coordinate_type>>> pairs;
+    for(std::size_t i=0; i<num_pairs; ++i)
+    {
+        const coordinate_type origin(0.0, 0.0, 0.0);
+        const coordinate_type center(dist(mt), 0.0, 0.0);
+        pairs.emplace_back(make_residue(mt, origin, natoms(mt)),
+                           make_residue(mt, center, natoms(mt)));
+    }
+
+#if defined(JARNGREIPR_WITHOUT_SIMD)
+    std::cout << "kernel: scalar\n";
+#elif defined(__AVX__)
+    std::cout << "kernel: AVX\n";
+#elif defined(__SSE2__)
+    std::cout << "kernel: SSE2\n";
+#else
+    std::cout << "kernel: scalar\n";
+#endif
+
+    std::size_t num_contacts_ref = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for(const auto& p : pairs)
+    {
+        if(jarngreipr::min_distance_sq(p.first, p.second) < threshold_sq)
+        {
+            ++num_contacts_ref;
+        }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    std::size_t num_contacts = 0;
+    for(const auto& p : pairs)
+    {
+        if(jarngreipr::any_pair_within(p.first, p.second, threshold_sq))
+        {
+            ++num_contacts;
+        }
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+
+    const auto ref = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+    const auto now = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1);
+    std::cout << "pairs          : " << num_pairs << '\n';
+    std::cout << "contacts       : " << num_contacts_ref << " (distance_sq loop), "
+              << num_contacts << " (any_pair_within)\n";
+    std::cout << "distance_sq    : " << ref.count() << " [us]\n";
+    std::cout << "any_pair_within: " << now.count() << " [us]\n";
+
+    return (num_contacts == num_contacts_ref) ? 0 : 1;
+}
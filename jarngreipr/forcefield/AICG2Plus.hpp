@@ -2,9 +2,12 @@
 #define JARNGREIPR_FORCEFIELD_AICG2_PLUS_H
 #include <extlib/toml/toml.hpp>
 #include <mjolnir/util/color.hpp>
-#include <jarngreipr/forcefield/remove_hydrogens.hpp>
+#include <jarngreipr/forcefield/make_cell_list.hpp>
+#include <jarngreipr/forcefield/inter_chain_contacts.hpp>
+#include <jarngreipr/pdb/atom_class.hpp>
 #include <jarngreipr/forcefield/ForceFieldGenerator.hpp>
 #include <jarngreipr/geometry/distance.hpp>
+#include <jarngreipr/geometry/min_distance.hpp>
 #include <jarngreipr/geometry/angle.hpp>
 #include <jarngreipr/geometry/dihedral.hpp>
 #include <jarngreipr/util/log.hpp>
@@ -13,6 +16,7 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <set>
 #include <limits>
 
 namespace jarngreipr
@@ -87,13 +91,12 @@ class AICG2Plus final : public ForceFieldGenerator<realT>
     ~AICG2Plus() override = default;
 
     // generate local parameters, not inter-chain contacts
-    toml::basic_value<toml::preserve_comments, std::map>&
-    generate(toml::basic_value<toml::preserve_comments, std::map>& out,
-             const group_type& chains) const override;
+    ForceField<realT>&
+    generate(ForceField<realT>& out, const group_type& chains) const override;
 
     // generate inter-chain contacts.
-    toml::basic_value<toml::preserve_comments, std::map>&
-    generate(toml::basic_value<toml::preserve_comments, std::map>& out,
+    ForceField<realT>&
+    generate(ForceField<realT>& out,
              const std::vector<std::reference_wrapper<const group_type>>& gs
              ) const override;
 
@@ -106,73 +109,41 @@ class AICG2Plus final : public ForceFieldGenerator<realT>
         return bead->has_attribute("flexible_regions");
     }
 
-    bool is_backbone(const atom_type& atom) const
-    {
-        return (atom.atom_name == " N  " || atom.atom_name == " C  " ||
-                atom.atom_name == " O  " || atom.atom_name == " OXT" ||
-                atom.atom_name == " CA ");
-    }
-    bool is_sidechain(const atom_type& atom) const
-    {
-        return !is_backbone(atom) &&
-            atom.atom_name.at(0) != 'H' && atom.atom_name.at(1) != 'H';
-    }
+    // atom classes are precomputed by CGBead, see atom_class.hpp
+    bool is_backbone (const std::uint8_t c) const noexcept {return (c & atom_class::backbone)  != 0;}
+    bool is_sidechain(const std::uint8_t c) const noexcept {return (c & atom_class::sidechain) != 0;}
+    bool is_donor    (const std::uint8_t c) const noexcept {return (c & atom_class::donor)     != 0;}
+    bool is_acceptor (const std::uint8_t c) const noexcept {return (c & atom_class::acceptor)  != 0;}
+    bool is_cation   (const std::uint8_t c) const noexcept {return (c & atom_class::cation)    != 0;}
+    bool is_anion    (const std::uint8_t c) const noexcept {return (c & atom_class::anion)     != 0;}
+    bool is_carbon   (const std::uint8_t c) const noexcept {return (c & atom_class::carbon)    != 0;}
 
-    bool is_donor(const atom_type& atom) const
-    {
-        return (atom.atom_name.at(1) == 'N' ||
-                (atom.residue_name == "SER" && atom.atom_name == " OG ") ||
-                (atom.residue_name == "THR" && atom.atom_name == " OG1") ||
-                (atom.residue_name == "TYR" && atom.atom_name == " OH ") ||
-                (atom.residue_name == "CYS" && atom.atom_name.at(1) == 'S'));
-    }
-    bool is_acceptor(const atom_type& atom) const
-    {
-        return (atom.atom_name.at(1) == 'O' || atom.atom_name.at(1) == 'S');
-    }
-    bool is_cation(const atom_type& atom) const
-    {
-	    return ((atom.residue_name == "ARG" && atom.atom_name == " NH1") ||
-                (atom.residue_name == "ARG" && atom.atom_name == " NH2") ||
-                (atom.residue_name == "LYS" && atom.atom_name == " NZ "));
-    }
-    bool is_anion(const atom_type& atom) const
-    {
-		return ((atom.residue_name == "GLU" && atom.atom_name == " OE1") ||
-                (atom.residue_name == "GLU" && atom.atom_name == " OE2") ||
-                (atom.residue_name == "ASP" && atom.atom_name == " OD1") ||
-                (atom.residue_name == "ASP" && atom.atom_name == " OD2"));
-    }
-    bool is_carbon(const atom_type& atom) const
-    {
-        return (atom.atom_name.at(1) == 'C');
-    }
-
-    bool is_donor_acceptor_pair(const atom_type& lhs, const atom_type& rhs) const
+    bool is_donor_acceptor_pair(const std::uint8_t lhs, const std::uint8_t rhs) const noexcept
     {
         return (is_acceptor(lhs) && is_donor(rhs)) ||
                (is_acceptor(rhs) && is_donor(lhs));
     }
-    bool is_cation_anion_pair(const atom_type& lhs, const atom_type& rhs) const
+    bool is_cation_anion_pair(const std::uint8_t lhs, const std::uint8_t rhs) const noexcept
     {
         return (is_cation(lhs) && is_anion(rhs)) ||
                (is_cation(rhs) && is_anion(lhs));
     }
 
-    real_type calc_contact_coef(const bead_ptr& bead1, const bead_ptr& bead2) const;
+    // it sweeps over the heavy atom pairs once and returns a pair of
+    // {whether any pair is closer than go_contact_threshold, coefficient}.
+    std::pair<bool, real_type>
+    calc_contact(const bead_ptr& bead1, const bead_ptr& bead2) const;
 
-    real_type min_distance_sq(const bead_ptr& bead1, const bead_ptr& bead2) const
+    real_type calc_contact_coef(const bead_ptr& bead1, const bead_ptr& bead2) const
     {
-        real_type min_dist_sq = std::numeric_limits<real_type>::max();
-        for(const auto& atom1 : remove_hydrogens(bead1->atoms()))
-        {
-            for(const auto& atom2 : remove_hydrogens(bead2->atoms()))
-            {
-                const real_type dist_sq = distance_sq(atom1.position, atom2.position);
-                min_dist_sq = std::min(dist_sq, min_dist_sq);
-            }
-        }
-        return min_dist_sq;
+        return this->calc_contact(bead1, bead2).second;
+    }
+
+    bool is_in_contact(const bead_ptr& bead1, const bead_ptr& bead2,
+                       const real_type threshold_sq) const
+    {
+        return any_pair_within(bead1->heavy_positions(),
+                               bead2->heavy_positions(), threshold_sq);
     }
 
     real_type limit_energy(const real_type val) const
@@ -231,28 +202,28 @@ class AICG2Plus final : public ForceFieldGenerator<realT>
 };
 
 template<typename realT>
-toml::basic_value<toml::preserve_comments, std::map>&
-AICG2Plus<realT>::generate(
-        toml::basic_value<toml::preserve_comments, std::map>& ff_,
-        const group_type& chains) const
+ForceField<realT>&
+AICG2Plus<realT>::generate(ForceField<realT>& ff, const group_type& chains) const
 {
-    using value_type = toml::basic_value<toml::preserve_comments, std::map>;
-    using array_type = value_type::array_type;
-    using table_type = value_type::table_type;
-
-    if(ff_.is_uninitialized())
-    {
-        ff_ = table_type{};
-    }
-
-    table_type& ff = ff_.as_table();
-    if(ff.count("local") == 0)
+    using value_type = typename ForceField<real_type>::value_type;
+    using table_type = typename value_type::table_type;
+    using param_type = ParameterTable<real_type>;
+
+    // bead j in chain k has ID `chain_offsets.at(k) + j` in the cell list.
+    const auto cell_list = make_cell_list(
+        std::vector<std::reference_wrapper<const chain_type>>(
+            chains.begin(), chains.end()), this->go_contact_threshold_);
+    std::vector<std::size_t> chain_offsets(1, 0);
+    for(const auto& chain : chains)
     {
-        ff["local"] = array_type{};
+        chain_offsets.push_back(chain_offsets.back() + chain.size());
     }
 
-    for(const auto& chain : chains)
+    for(std::size_t chain_idx = 0; chain_idx < chains.size(); ++chain_idx)
     {
+        const auto& chain  = chains.at(chain_idx);
+        const auto& beads  = chain.table(); // flat copy of positions, indices
+        const auto  offset = chain_offsets.at(chain_idx);
         log::info("generating AICG2+ parameters for chain ", chain.name(), '\n');
         if(!this->check_beads_kind(chain))
         {
@@ -260,7 +231,7 @@ AICG2Plus<realT>::generate(
                 << '[' << mjolnir::io::red << "error" << mjolnir::io::nocolor
                 << "] AICG2+: Invalid Bead Kind. stop parameter generation"
                 << std::endl;
-            return ff_;
+            return ff;
         }
 
         // --------------------------------------------------------------------
@@ -271,23 +242,19 @@ AICG2Plus<realT>::generate(
             // So here, first search a table that defines the same forcefield.
             // If it exists, push new parameters to the found one. Otherwise,
             // add a new table and push to it.
-            auto& params = find_or_push_table(ff.at("local"), value_type{
+            auto& params = ff.find_or_push_local(value_type{
                     {"interaction", "BondLength"},
                     {"potential",   "Harmonic"},
-                    {"topology",    "bond"},
-                    {"parameters",  array_type{}}
+                    {"topology",    "bond"}
                 }, /* the keys that should be equivalent = */ {
                     "interaction", "potential", "topology"
-                }).as_table().at("parameters").as_array();
-            params.reserve(params.size() + chain.size());
+                }, param_type(2, {"v0", "k"}));
 
             for(std::size_t i=1, sz = chain.size(); i<sz; ++i)
             {
-                const auto& bead1 = chain.at(i-1);
-                const auto& bead2 = chain.at(i);
-                const auto  i1    = bead1->index();
-                const auto  i2    = bead2->index();
-                const auto  dist  = distance(bead1->position(), bead2->position());
+                const auto  i1    = beads.index(i-1);
+                const auto  i2    = beads.index(i);
+                const auto  dist  = distance(beads.position(i-1), beads.position(i));
 
                 if(dist > this->native_bond_warning_)
                 {
@@ -295,39 +262,32 @@ AICG2Plus<realT>::generate(
                         "[angst.] seems to be too large.\n");
                 }
 
-                value_type para = table_type{
-                    {"indices", array_type{i1, i2}},
-                    {"v0"     , dist              },
-                    {"k"      , this->cbd_aicg2_  }
-                };
+                params.push_back({i1, i2}, {dist, this->cbd_aicg2_});
                 if(i == 1)
                 {
-                    para.comments().push_back(std::string(" AICG2+ Bond Length "
-                        "Potential for chain ") + chain.name());
+                    params.add_comment(params.size() - 1, std::string(
+                        " AICG2+ Bond Length Potential for chain ") + chain.name());
                 }
-                params.push_back(std::move(para));
             }
         }
         // --------------------------------------------------------------------
         // generate 1-3 contact
         {
-            auto& params = find_or_push_table(ff.at("local"), value_type{
+            auto& params = ff.find_or_push_local(value_type{
                 {"interaction", "BondLength"},
                 {"potential",   "Gaussian"},
-                {"topology",    "none"},
-                {"parameters",  array_type{}}
+                {"topology",    "none"}
             }, /* the keys that should be equivalent = */ {
                 "interaction", "potential", "topology"
-            }).as_table().at("parameters").as_array();
-            params.reserve(params.size() + chain.size());
+            }, param_type(2, {"v0", "sigma", "k"}));
 
             for(std::size_t i=2, sz = chain.size(); i<sz; ++i)
             {
                 const auto& bead1 = chain.at(i-2);
                 const auto& bead2 = chain.at(i-1);
                 const auto& bead3 = chain.at(i);
-                const auto  i1    = bead1->index();
-                const auto  i3    = bead3->index();
+                const auto  i1    = beads.index(i-2);
+                const auto  i3    = beads.index(i);
 
                 // if the beads contains flexible region, remove 1-3 contact.
                 if(is_in_flexible_region(bead1) || is_in_flexible_region(bead2) ||
@@ -335,21 +295,16 @@ AICG2Plus<realT>::generate(
                 {
                     continue;
                 }
-                const auto nat_dist = distance(bead1->position(), bead3->position());
+                const auto nat_dist = distance(beads.position(i-2), beads.position(i));
                 const auto contact_coef = this->calc_contact_coef(bead1, bead3);
 
-                value_type para = table_type{
-                    {"indices", value_type{i1, i3}           },
-                    {"v0"     , nat_dist                     },
-                    {"sigma"  , this->wid_aicg13_            },
-                    {"k"      , this->coef_13_ * contact_coef}
-                };
+                params.push_back({i1, i3},
+                    {nat_dist, this->wid_aicg13_, this->coef_13_ * contact_coef});
                 if(i == 2)
                 {
-                    para.comments().push_back(std::string(" AICG2+ 1-3 Contact "
-                        "Potential for chain ") + chain.name());
+                    params.add_comment(params.size() - 1, std::string(
+                        " AICG2+ 1-3 Contact Potential for chain ") + chain.name());
                 }
-                params.push_back(std::move(para));
             }
         }
         /* flexible-local-angle */{
@@ -357,8 +312,7 @@ AICG2Plus<realT>::generate(
                 {"interaction", "BondAngle"},
                 {"potential",   "FlexibleLocalAngle"},
                 {"topology",    "none"},
-                {"env", {}},
-                {"parameters",  array_type{}}
+                {"env", {}}
             };
             const std::string y1_prefix("y1_");
             const std::string y2_prefix("y2_");
@@ -379,34 +333,24 @@ AICG2Plus<realT>::generate(
                 env["default_x"] = this->angle_x_;
                 flp_angle.as_table().at("env") = std::move(env);
             }
-            auto& params = find_or_push_table(ff.at("local"), flp_angle,
+            auto& params = ff.find_or_push_local(flp_angle,
                 /* the keys that should be equivalent = */ {
                     "interaction", "potential", "topology", "env"
-                }).as_table().at("parameters").as_array();
-            params.reserve(params.size() + chain.size());
+                }, param_type(3, {"k"}, {"x", "y", "d2y"}));
 
             for(std::size_t i=2, sz = chain.size(); i<sz; ++i)
             {
-                const auto& bead1 = chain.at(i-2);
-                const auto& bead2 = chain.at(i-1);
-                const auto& bead3 = chain.at(i);
-                const auto  i1    = bead1->index();
-                const auto  i2    = bead2->index();
-                const auto  i3    = bead3->index();
-
-                value_type para = table_type{
-                    {"indices", value_type{i1, i2, i3}   },
-                    {"k"      , this->k_angle_           },
-                    {"x"      , "default_x"              },
-                    {"y"      , y1_prefix + bead2->name()},
-                    {"d2y"    , y2_prefix + bead2->name()}
-                };
+                const auto  i1    = beads.index(i-2);
+                const auto  i2    = beads.index(i-1);
+                const auto  i3    = beads.index(i);
+
+                params.push_back({i1, i2, i3}, {this->k_angle_}, {"default_x",
+                    y1_prefix + beads.name(i-1), y2_prefix + beads.name(i-1)});
                 if(i == 2)
                 {
-                    para.comments().push_back(std::string(" AICG2+ Flexible "
-                        "Local Angle Potential for chain ") + chain.name());
+                    params.add_comment(params.size() - 1, std::string(" AICG2+ "
+                        "Flexible Local Angle Potential for chain ") + chain.name());
                 }
-                params.push_back(std::move(para));
             }
         }
         /* dihedral-angle */{
@@ -419,15 +363,15 @@ AICG2Plus<realT>::generate(
                 {"interaction", "DihedralAngle"},
                 {"potential"  , "Gaussian+FlexibleLocalDihedral"},
                 {"topology"   , "none"},
-                {"env"        , env},
-                {"parameters",  array_type{}}
+                {"env"        , env}
             };
 
-            auto& params = find_or_push_table(ff.at("local"), aicg_flp_dihd,
+            auto& params = ff.find_or_push_local(aicg_flp_dihd,
                 /* the keys that should be equivalent = */ {
                     "interaction", "potential", "topology", "env"
-                }).as_table().at("parameters").as_array();
-            params.reserve(params.size() + chain.size());
+                }, param_type(4, {"Gaussian.v0", "Gaussian.sigma", "Gaussian.k",
+                                  "FlexibleLocalDihedral.k"},
+                                 {"FlexibleLocalDihedral.coef"}));
 
             for(std::size_t i=3, sz = chain.size(); i<sz; ++i)
             {
@@ -435,175 +379,137 @@ AICG2Plus<realT>::generate(
                 const auto& bead2 = chain.at(i-2);
                 const auto& bead3 = chain.at(i-1);
                 const auto& bead4 = chain.at(i);
-                const auto  i1    = bead1->index();
-                const auto  i2    = bead2->index();
-                const auto  i3    = bead3->index();
-                const auto  i4    = bead4->index();
+                const auto  i1    = beads.index(i-3);
+                const auto  i2    = beads.index(i-2);
+                const auto  i3    = beads.index(i-1);
+                const auto  i4    = beads.index(i);
 
                 const auto nat_dihd = dihedral_angle(
-                                        bead1->position(), bead2->position(),
-                                        bead3->position(), bead4->position());
+                                        beads.position(i-3), beads.position(i-2),
+                                        beads.position(i-1), beads.position(i));
                 const auto contact_coef = this->calc_contact_coef(bead1, bead4);
 
-                value_type para = table_type{
-                    {"indices", value_type{i1, i2, i3, i4}   },
-                    {"Gaussian", table_type{
-                        {"v0"     , nat_dihd                     },
-                        {"sigma"  , this->wid_dih_               },
-                        {"k"      , this->coef_14_ * contact_coef}
-                    }},
-                    {"FlexibleLocalDihedral", table_type{
-                        {"k"      , this->k_dihedral_                  },
-                        {"coef"   , bead2->name() + '-' + bead3->name()}
-                    }}
-                };
-
                 // if the beads contains flexible region, remove 1-4 contact.
                 // but keep FLP dihedral
-                if(is_in_flexible_region(bead1) || is_in_flexible_region(bead2) ||
-                   is_in_flexible_region(bead3) || is_in_flexible_region(bead4))
-                {
-                    para.at("Gaussian").at("k") = 0.0;
-                }
+                const bool is_flexible =
+                    is_in_flexible_region(bead1) || is_in_flexible_region(bead2) ||
+                    is_in_flexible_region(bead3) || is_in_flexible_region(bead4);
+
+                params.push_back({i1, i2, i3, i4}, {nat_dihd, this->wid_dih_,
+                    is_flexible ? real_type(0.0) : this->coef_14_ * contact_coef,
+                    this->k_dihedral_}, {beads.name(i-2) + '-' + beads.name(i-1)});
                 if(i == 3)
                 {
-                    para.comments().push_back(std::string(" AICG2+ Dihedral "
-                        "Potential for chain ") + chain.name());
+                    params.add_comment(params.size() - 1, std::string(
+                        " AICG2+ Dihedral Potential for chain ") + chain.name());
                 }
-                params.push_back(std::move(para));
             }
         }
 
-        const real_type th2 = this->go_contact_threshold_ *
-                              this->go_contact_threshold_;
         /* intra-chain-go-contacts */
         if(4 < chain.size()) // if chain has <4 atoms, no contact would be formed
         {
-            auto& params = find_or_push_table(ff.at("local"), value_type{
+            auto& params = ff.find_or_push_local(value_type{
                 {"interaction", "BondLength"},
                 {"potential",   "GoContact"},
-                {"topology",    "contact"},
-                {"parameters",  array_type{}}
+                {"topology",    "contact"}
             }, /* the keys that should be equivalent = */ {
                 "interaction", "potential", "topology"
-            }).as_table().at("parameters").as_array();
-            params.reserve(params.size() + chain.size());
-
-            bool first = true;
-            for(std::size_t i=0, sz_i = chain.size()-4; i<sz_i; ++i)
-            {
-                for(std::size_t j=i+4, sz_j = chain.size(); j<sz_j; ++j)
+            }, param_type(2, {"v0", "k"}));
+
+            // each row i is filled independently and merged in order.
+            std::vector<param_type> rows(chain.size() - 4, params.empty_copy());
+            this->thread_pool().parallel_for(0, rows.size(),
+                [&](const std::size_t i) -> void {
+                // candidates are sorted, so j is visited in ascending order
+                for(const auto neighbor : cell_list.neighbors(offset + i))
                 {
-                    if(this->min_distance_sq(chain.at(i), chain.at(j)) < th2)
+                    if(neighbor < offset + i + 4 || offset + chain.size() <= neighbor)
                     {
-                        const auto& bead1 = chain.at(i);
-                        const auto& bead2 = chain.at(j);
-                        const auto  i1    = bead1->index();
-                        const auto  i2    = bead2->index();
+                        continue;
+                    }
+                    const std::size_t j = neighbor - offset;
+                    const auto& bead1 = chain.at(i);
+                    const auto& bead2 = chain.at(j);
 
-                        // if one of the bead is flexible region, continue.
-                        if(is_in_flexible_region(bead1) || is_in_flexible_region(bead2))
-                        {
-                            continue;
-                        }
+                    // if one of the bead is flexible region, continue.
+                    if(is_in_flexible_region(bead1) || is_in_flexible_region(bead2))
+                    {
+                        continue;
+                    }
 
+                    // contact detection and the coefficient in one sweep
+                    const auto contact = this->calc_contact(bead1, bead2);
+                    if(contact.first)
+                    {
+                        const auto i1 = beads.index(i);
+                        const auto i2 = beads.index(j);
                         const auto nat_dist =
-                            distance(bead1->position(), bead2->position());
-                        const auto contact_coef =
-                            calc_contact_coef(bead1, bead2);
-
-                        value_type para = table_type{
-                            {"indices", value_type{i1, i2}            },
-                            {"v0"     , nat_dist                      },
-                            {"k"      , -this->coef_go_ * contact_coef}
-                        };
-                        if(first)
-                        {
-                            para.comments().push_back(std::string(" AICG2+ "
-                                "Contact Potential for chain ") + chain.name());
-                            first = false;
-                        }
-                        params.push_back(std::move(para));
+                            distance(beads.position(i), beads.position(j));
+
+                        rows[i].push_back({i1, i2},
+                                          {nat_dist, -this->coef_go_ * contact.second});
                     }
                 }
-            }
+            });
+            append_rows(params, rows, std::string(" AICG2+ "
+                "Contact Potential for chain ") + chain.name());
         }
     }
 
     // (inter-chain & intra-group) go contact
     {
-        const real_type th2 = this->go_contact_threshold_ *
-                              this->go_contact_threshold_;
-
-        auto& params = find_or_push_table(ff.at("local"), value_type{
+        auto& params = ff.find_or_push_local(value_type{
             {"interaction", "BondLength"},
             {"potential",   "GoContact"},
-            {"topology",    "contact"},
-            {"parameters",  array_type{}}
+            {"topology",    "contact"}
         }, /* the keys that should be equivalent = */ {
             "interaction", "potential", "topology"
-        }).as_table().at("parameters").as_array();
+        }, param_type(2, {"v0", "k"}));
+
+        const auto contacts = find_inter_chain_contacts(this->thread_pool(),
+            cell_list, chain_offsets,
+            [](const std::size_t, const std::size_t) noexcept {return true;},
+            [&](const std::size_t chain_i, const std::size_t idx1,
+                const std::size_t chain_j, const std::size_t idx2
+                ) -> std::pair<bool, real_type> {
+                const auto& bead1 = chains.at(chain_i).at(idx1);
+                const auto& bead2 = chains.at(chain_j).at(idx2);
+
+                // if one of the beads is flexible region, skip it.
+                if(is_in_flexible_region(bead1) || is_in_flexible_region(bead2))
+                {
+                    return std::make_pair(false, real_type(0));
+                }
+                const auto contact = this->calc_contact(bead1, bead2);
+                return std::make_pair(contact.first, -this->coef_go_ * contact.second);
+            });
 
         for(std::size_t chain_i = 0; chain_i < chains.size(); ++chain_i)
         {
             const auto& chain1 = chains.at(chain_i);
-            for(std::size_t chain_j=chain_i+1; chain_j<chains.size(); ++chain_j)
+            const auto& found  = contacts.at(chain_i);
+            for(auto first = found.begin(); first != found.end();)
             {
-                const auto& chain2 = chains.at(chain_j);
-
-                bool first = true;
-                for(const auto& bead1 : chain1)
-                {
-                    for(const auto& bead2 : chain2)
-                    {
-                        if(this->min_distance_sq(bead1, bead2) < th2)
-                        {
-                            const auto i1 = bead1->index();
-                            const auto i2 = bead2->index();
-
-                            // if one of the beads is flexible region, skip it.
-                            if(is_in_flexible_region(bead1) ||
-                               is_in_flexible_region(bead2))
-                            {
-                                continue;
-                            }
-
-                            const auto nat_dist =
-                                distance(bead1->position(), bead2->position());
-                            const auto contact_coef =
-                                calc_contact_coef(bead1, bead2);
-
-                            value_type para = table_type{
-                                {"indices", value_type{i1, i2}            },
-                                {"v0"     , nat_dist                      },
-                                {"k"      , -this->coef_go_ * contact_coef}
-                            };
-                            if(first)
-                            {
-                                para.comments().push_back(std::string(" AICG2+ "
-                                    "Contact Potential between chain ") +
-                                    chain1.name() + " and " + chain2.name());
-                                first = false;
-                            }
-                            params.push_back(std::move(para));
-                        }
-                    }
-                }
+                const auto& chain2 = chains.at(first->partner);
+                const auto  last   = contacts_with(found, first->partner).second;
+                append_contacts(params, chain1, chain2, first, last,
+                    std::string(" AICG2+ Contact Potential between chain ") +
+                    chain1.name() + " and " + chain2.name());
+                first = last;
             }
         }
     }
-    return ff_;
+    return ff;
 }
 
 template<typename realT>
-toml::basic_value<toml::preserve_comments, std::map>&
-AICG2Plus<realT>::generate(
-        toml::basic_value<toml::preserve_comments, std::map>& ff_,
+ForceField<realT>&
+AICG2Plus<realT>::generate(ForceField<realT>& ff,
         const std::vector<std::reference_wrapper<const group_type>>& gs) const
 {
-    using value_type = toml::basic_value<toml::preserve_comments, std::map>;
-    using array_type = value_type::array_type;
-    using table_type = value_type::table_type;
+    using value_type = typename ForceField<real_type>::value_type;
+    using param_type = ParameterTable<real_type>;
 
     log::debug("generating inter-chain AICG2+ parameters\n");
     for(const auto& g : gs)
@@ -611,29 +517,55 @@ AICG2Plus<realT>::generate(
         log::debug("- ", g.get().name(), "\n");
     }
 
-    if(ff_.is_uninitialized())
-    {
-        ff_ = table_type{};
-    }
-
-    table_type& ff = ff_.as_table();
-    if(ff.count("local") == 0)
-    {
-        ff["local"] = array_type{};
-    }
-
-    const auto th2 = this->go_contact_threshold_ * this->go_contact_threshold_;
-
-    auto& params = find_or_push_table(ff.at("local"), value_type{
+    auto& params = ff.find_or_push_local(value_type{
         {"interaction", "BondLength"},
         {"potential",   "GoContact"},
-        {"topology",    "contact"},
-        {"parameters",  array_type{}}
+        {"topology",    "contact"}
     }, /* the keys that should be equivalent = */ {
         "interaction", "potential", "topology"
-    }).as_table().at("parameters").as_array();
+    }, param_type(2, {"v0", "k"}));
+
+    // the c-th chain of the g-th group is `all_chains.at(first_chain.at(g) + c)`
+    // and its k-th bead has ID `chain_offsets.at(first_chain.at(g) + c) + k`
+    std::vector<std::reference_wrapper<const chain_type>> all_chains;
+    std::vector<std::size_t> group_of;
+    std::vector<std::size_t> first_chain;
+    std::vector<std::size_t> chain_offsets(1, 0);
+    for(std::size_t g=0; g<gs.size(); ++g)
+    {
+        first_chain.push_back(all_chains.size());
+        for(const auto& chain : gs.at(g).get())
+        {
+            all_chains.push_back(std::cref(chain));
+            group_of.push_back(g);
+            chain_offsets.push_back(chain_offsets.back() + chain.size());
+        }
+    }
+    const auto cell_list = make_cell_list(all_chains, this->go_contact_threshold_);
+
+    const auto contacts = find_inter_chain_contacts(this->thread_pool(),
+        cell_list, chain_offsets,
+        [&](const std::size_t c1, const std::size_t c2) -> bool {
+            return group_of.at(c1) != group_of.at(c2) &&
+                   all_chains.at(c1).get().name() != all_chains.at(c2).get().name();
+        },
+        [&](const std::size_t c1, const std::size_t idx1,
+            const std::size_t c2, const std::size_t idx2
+            ) -> std::pair<bool, real_type> {
+            const auto& bead1 = all_chains.at(c1).get().at(idx1);
+            const auto& bead2 = all_chains.at(c2).get().at(idx2);
+
+            // if one of the beads is flexible region, skip it.
+            if(is_in_flexible_region(bead1) || is_in_flexible_region(bead2))
+            {
+                return std::make_pair(false, real_type(0));
+            }
+            const auto contact = this->calc_contact(bead1, bead2);
+            return std::make_pair(contact.first, -this->coef_go_ * contact.second);
+        });
 
-    std::vector<std::pair<std::string, std::string>> combinations;
+    // pairs of chain names already generated, stored as {min, max}
+    std::set<std::pair<std::string, std::string>> combinations;
 
     for(std::size_t i=0; i<gs.size(); ++i)
     {
@@ -643,78 +575,68 @@ AICG2Plus<realT>::generate(
     {
         const auto& rhs = gs.at(j).get();
 
-    for(const auto& chain1 : lhs)
+    for(std::size_t chain_i=0; chain_i<lhs.size(); ++chain_i)
     {
-        for(const auto& chain2 : rhs)
+        const auto& chain1 = lhs.at(chain_i);
+        const auto& found  = contacts.at(first_chain.at(i) + chain_i);
+
+        for(std::size_t chain_j=0; chain_j<rhs.size(); ++chain_j)
         {
+            const auto& chain2 = rhs.at(chain_j);
+
             // intra chain. skip
             if(chain1.name() == chain2.name())
             {
                 continue;
             }
             // combination already found
-            if(std::find_if(combinations.begin(), combinations.end(),
-                [&](const std::pair<std::string, std::string>& c){
-                    return (c.first == chain2.name() && c.second == chain1.name()) ||
-                           (c.first == chain1.name() && c.second == chain2.name());
-                }) != combinations.end())
+            if(!combinations.insert(std::make_pair(
+                    std::min(chain1.name(), chain2.name()),
+                    std::max(chain1.name(), chain2.name()))).second)
             {
                 continue;
             }
-            combinations.push_back(std::make_pair(chain1.name(), chain2.name()));
 
+            const auto range = contacts_with(found, first_chain.at(j) + chain_j);
+            if(range.first == range.second)
+            {
+                continue;
+            }
             log::info("generating AICG2+ parameters between chain ",
                       chain1.name(), " and ", chain2.name(), '\n');
 
-            bool is_first = true;
-            for(const auto& bead1 : chain1)
-            {
-                for(const auto& bead2 : chain2)
-                {
-                    if(this->min_distance_sq(bead1, bead2) < th2)
-                    {
-                        const auto i1 = bead1->index();
-                        const auto i2 = bead2->index();
-
-                        // if one of the bead is flexible region, continue.
-                        if(is_in_flexible_region(bead1) || is_in_flexible_region(bead2))
-                        {
-                            continue;
-                        }
-
-                        value_type para = table_type{
-                            {"indices", value_type{i1, i2}},
-                            {"v0"     , distance(bead1->position(), bead2->position())},
-                            {"k"      , -coef_go_ * this->calc_contact_coef(bead1, bead2)}
-                        };
-                        if(is_first)
-                        {
-                            para.comments().push_back(" AICG2+ Contact "
-                                "Potential between chain " + chain1.name() +
-                                " and chain " + chain2.name());
-                            is_first = false;
-                        }
-                        params.push_back(std::move(para));
-                    }
-                }
-            }
+            append_contacts(params, chain1, chain2, range.first, range.second,
+                " AICG2+ Contact Potential between chain " + chain1.name() +
+                " and chain " + chain2.name());
         }
     }
     } // rhs
     } // lhs
 
-    return ff_;
+    return ff;
 }
 
 template<typename realT>
-typename AICG2Plus<realT>::real_type
-AICG2Plus<realT>::calc_contact_coef(
+std::pair<bool, typename AICG2Plus<realT>::real_type>
+AICG2Plus<realT>::calc_contact(
         const bead_ptr& bead1, const bead_ptr& bead2) const
 {
+    // cutoffs are compared with squared distances. sqrt is not needed here.
+    const real_type go_contact_threshold_sq =
+        this->go_contact_threshold_ * this->go_contact_threshold_;
+    const real_type atom_contact_cutoff_sq =
+        this->atom_contact_cutoff_ * this->atom_contact_cutoff_;
+    const real_type hydrogen_bond_cutoff_sq =
+        this->hydrogen_bond_cutoff_ * this->hydrogen_bond_cutoff_;
+    const real_type salt_bridge_cutoff_sq =
+        this->salt_bridge_cutoff_ * this->salt_bridge_cutoff_;
+
     // AICG2+ parameters should be used for Ca-Ca pair.
-    if(bead1->kind() != "CarbonAlpha" || bead2->kind() != "CarbonAlpha")
+    if(bead1->kind() != CGBeadKind::CarbonAlpha ||
+       bead2->kind() != CGBeadKind::CarbonAlpha)
     {
-        return 0.3; // the default value
+        return std::make_pair(this->is_in_contact(bead1, bead2,
+                    go_contact_threshold_sq), real_type(0.3)); // default value
     }
 
     std::size_t num_bb_hb = 0; // backbone-backbone hydrogen bond
@@ -738,17 +660,23 @@ AICG2Plus<realT>::calc_contact_coef(
     std::int32_t num_short = 0; // short range contact
     std::int32_t num_long  = 0; // long range contact
 
-    for(const auto& atom1 : remove_hydrogens(bead1->atoms()))
+    const auto& heavy_clss1 = bead1->heavy_atom_classes();
+    const auto& heavy_clss2 = bead2->heavy_atom_classes();
+    const auto& heavy_poss1 = bead1->heavy_positions();
+    const auto& heavy_poss2 = bead2->heavy_positions();
+    for(std::size_t idx1=0; idx1<heavy_clss1.size(); ++idx1)
     {
-        for(const auto& atom2 : remove_hydrogens(bead2->atoms()))
+        const auto atom1 = heavy_clss1[idx1];
+        for(std::size_t idx2=0; idx2<heavy_clss2.size(); ++idx2)
         {
-            const auto dist = distance(atom1.position, atom2.position);
+            const auto atom2 = heavy_clss2[idx2];
+            const auto  dist2 = distance_sq(heavy_poss1[idx1], heavy_poss2[idx2]);
 
-            if(dist < go_contact_threshold_)
+            if(dist2 < go_contact_threshold_sq)
             {
                 num_long += 1;
             }
-            if(atom_contact_cutoff_ <= dist)
+            if(atom_contact_cutoff_sq <= dist2)
             {
                 // out of cutoff range. no contact between atom1 and atom2.
                 continue;
@@ -760,7 +688,7 @@ AICG2Plus<realT>::calc_contact_coef(
             {
                 if(is_donor_acceptor_pair(atom1, atom2))
                 {
-                    if(dist < hydrogen_bond_cutoff_)
+                    if(dist2 < hydrogen_bond_cutoff_sq)
                     {
                         num_bb_hb += 1;
                     }
@@ -784,7 +712,7 @@ AICG2Plus<realT>::calc_contact_coef(
                 {
                     if(is_cation_anion_pair(atom1, atom2))
                     {
-                        if(dist < salt_bridge_cutoff_)
+                        if(dist2 < salt_bridge_cutoff_sq)
                         {
                             num_ss_sb += 1;
                         }
@@ -793,7 +721,7 @@ AICG2Plus<realT>::calc_contact_coef(
                             num_ss_cc += 1;
                         }
                     }
-                    else if(dist < hydrogen_bond_cutoff_)
+                    else if(dist2 < hydrogen_bond_cutoff_sq)
                     {
                         num_ss_hb += 1;
                     }
@@ -826,7 +754,7 @@ AICG2Plus<realT>::calc_contact_coef(
             {
                 if(is_donor_acceptor_pair(atom1, atom2))
                 {
-                    if(dist < hydrogen_bond_cutoff_)
+                    if(dist2 < hydrogen_bond_cutoff_sq)
                     {
                         num_bs_hb += 1; // hydrogen bond formed.
                     }
@@ -857,6 +785,9 @@ AICG2Plus<realT>::calc_contact_coef(
         } // atom2
     } // atom1
 
+    // at least one pair of atoms is within the go_contact_threshold
+    const bool found_contact = (num_long != 0);
+
     // XXX pair of residues cannot form more than one salty bridge.
     // set the number of salty bridge to 1, and the rests are counted as
     // sidechain-sidechain charge contact(backbone never forms salty bridge).
@@ -895,18 +826,18 @@ AICG2Plus<realT>::calc_contact_coef(
         this->bs_other_contact_   * num_bs_oc +
         this->long_range_contact_ * num_long;
 
-    return this->limit_energy(e_tot);
+    return std::make_pair(found_contact, this->limit_energy(e_tot));
 }
 
 template<typename realT>
 bool AICG2Plus<realT>::check_beads_kind(const chain_type& chain) const
 {
-    for(const auto& bead : chain)
+    for(const auto kind : chain.table().kinds())
     {
-        if(bead->kind() != "CarbonAlpha")
+        if(kind != CGBeadKind::CarbonAlpha)
         {
             std::cerr << "AICG2Plus: invalid coarse-grained bead kind: "
-                      << bead->kind() << '\n';
+                      << kind << '\n';
             std::cerr << "it allows only CarbonAlpha beads.\n";
             return false;
         }
@@ -3,6 +3,7 @@
 #include <extlib/toml/toml.hpp>
 #include <jarngreipr/forcefield/ForceFieldGenerator.hpp>
 #include <jarngreipr/geometry/distance.hpp>
+#include <jarngreipr/geometry/min_distance.hpp>
 #include <jarngreipr/geometry/angle.hpp>
 #include <jarngreipr/geometry/dihedral.hpp>
 #include <iterator>
@@ -51,18 +52,11 @@ class ClementiGo final : public ForceFieldGenerator<realT>
 
   private:
 
-    real_type min_distance_sq(const bead_ptr& bead1, const bead_ptr& bead2) const
+    bool is_in_contact(const bead_ptr& bead1, const bead_ptr& bead2,
+                       const real_type threshold_sq) const
     {
-        real_type min_dist_sq = std::numeric_limits<real_type>::max();
-        for(const auto& atom1 : remove_hydrogens(bead1->atoms()))
-        {
-            for(const auto& atom2 : remove_hydrogens(bead2->atoms()))
-            {
-                const auto dsq = distance_sq(atom1.position, atom2.position);
-                min_dist_sq = std::min(dsq, min_dist_sq);
-            }
-        }
-        return min_dist_sq;
+        return any_pair_within(bead1->heavy_positions(),
+                               bead2->heavy_positions(), threshold_sq);
     }
 
   private:
@@ -201,7 +195,7 @@ ClementiGo<realT>::generate(
             {
                 for(std::size_t j=i+4, sz_j = chain.size(); j<sz_j; ++j)
                 {
-                    if(this->min_distance_sq(chain.at(i), chain.at(j)) < th2)
+                    if(this->is_in_contact(chain.at(i), chain.at(j), th2))
                     {
                         const auto& bead1 = chain.at(i);
                         const auto& bead2 = chain.at(j);
@@ -260,7 +254,7 @@ ClementiGo<realT>::generate(
             {
                 for(const auto& bead2 : chain2)
                 {
-                    if(this->min_distance_sq(bead1, bead2) < th2)
+                    if(this->is_in_contact(bead1, bead2, th2))
                     {
                         const auto i1 = bead1->index();
                         const auto i2 = bead2->index();
@@ -286,7 +280,7 @@ bool ClementiGo<realT>::check_beads_kind(const chain_type& chain) const
 {
     for(const auto& bead : chain)
     {
-        if(bead->kind() != "CarbonAlpha")
+        if(bead->kind() != CGBeadKind::CarbonAlpha)
         {
             std::cerr << "ClementiGo: invalid coarse-grained bead kind: "
                       << bead->kind() << '\n';
@@ -25,12 +25,11 @@ class DebyeHuckel final : public ForceFieldGenerator<realT>
     {}
     ~DebyeHuckel() override = default;
 
-    toml::basic_value<toml::preserve_comments, std::map>&
-    generate(toml::basic_value<toml::preserve_comments, std::map>& out,
-             const group_type& chains) const override;
+    ForceField<realT>&
+    generate(ForceField<realT>& out, const group_type& chains) const override;
 
-    toml::basic_value<toml::preserve_comments, std::map>&
-    generate(toml::basic_value<toml::preserve_comments, std::map>& out,
+    ForceField<realT>&
+    generate(ForceField<realT>& out,
              const std::vector<std::reference_wrapper<const group_type>>& gs
              ) const override;
 
@@ -46,36 +45,22 @@ class DebyeHuckel final : public ForceFieldGenerator<realT>
 };
 
 template<typename realT>
-toml::basic_value<toml::preserve_comments, std::map>&
-DebyeHuckel<realT>::generate(
-        toml::basic_value<toml::preserve_comments, std::map>& ff_,
-        const group_type& chains) const
+ForceField<realT>&
+DebyeHuckel<realT>::generate(ForceField<realT>& ff, const group_type& chains) const
 {
     throw std::runtime_error("DebyeHuckel is global-only potential");
 }
 
 template<typename realT>
-toml::basic_value<toml::preserve_comments, std::map>&
-DebyeHuckel<realT>::generate(
-    toml::basic_value<toml::preserve_comments, std::map>& ff_,
+ForceField<realT>&
+DebyeHuckel<realT>::generate(ForceField<realT>& ff,
     const std::vector<std::reference_wrapper<const group_type>>& groups) const
 {
-    using value_type = toml::basic_value<toml::preserve_comments, std::map>;
-    using array_type = value_type::array_type;
-    using table_type = value_type::table_type;
+    using value_type = typename ForceField<real_type>::value_type;
+    using table_type = typename value_type::table_type;
+    using param_type = ParameterTable<real_type>;
 
-    if(ff_.is_uninitialized())
-    {
-        ff_ = table_type{};
-    }
-
-    table_type& ff = ff_.as_table();
-    if(ff.count("global") == 0)
-    {
-        ff["global"] = array_type{};
-    }
-
-    toml::basic_value<toml::preserve_comments, std::map> ele{
+    value_type ele{
         {"interaction", "Pair"       },
         {"potential"  , "DebyeHuckel"},
         // TODO input ignoring stuff
@@ -86,14 +71,13 @@ DebyeHuckel<realT>::generate(
         {"spatial_partition", table_type{
                 {"type", "CellList"}, {"margin", 0.5}
             }
-        },
-        {"parameters",  array_type{}}
+        }
     };
 
-    auto& params = find_or_push_table(ff.at("global"), ele,
+    auto& params = ff.find_or_push_global(ele,
         /* the keys that should be equivalent = */ {
             "interaction", "potential", "ignore", "spatial_partition",
-        }).as_table().at("parameters").as_array();
+        }, param_type(1, {"charge"}));
 
     for(const auto& group : groups)
     {
@@ -104,15 +88,12 @@ DebyeHuckel<realT>::generate(
                 const auto charge = this->charges_.at(bead->name());
                 if(charge != 0)
                 {
-                    table_type para;
-                    para["index"]  = bead->index();
-                    para["charge"] = charge;
-                    params.push_back(std::move(para));
+                    params.push_back({bead->index()}, {charge});
                 }
             }
         }
     }
-    return ff_;
+    return ff;
 }
 
 } // jarngreipr
@@ -0,0 +1,124 @@
+#ifndef JARNGREIPR_FORCEFIELD_ENSEMBLE_GO_CONTACT_HPP
+#define JARNGREIPR_FORCEFIELD_ENSEMBLE_GO_CONTACT_HPP
+#include <extlib/toml/toml.hpp>
+#include <jarngreipr/forcefield/ForceField.hpp>
+#include <jarngreipr/forcefield/ensemble_contacts.hpp>
+#include <jarngreipr/geometry/distance.hpp>
+#include <jarngreipr/util/log.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace jarngreipr
+{
+
+// Go contacts weighted by how often the pair is in contact in an ensemble,
+// e.g. the models of an NMR structure, for multi-basin Go models.
+//
+// A pair of beads that are in contact in a fraction f of the models has
+// `k = -coef_contact * f`, and `v0` is the distance in the reference group.
+// Unlike GoContact, pairs in the same chain are also included if they are
+// separated by `min_separation` or more in the sequence.
+//
+// It is not a ForceFieldGenerator because it needs all the models of a group.
+template<typename realT>
+class EnsembleGoContact
+{
+  public:
+    using real_type  = realT;
+    using chain_type = CGChain<real_type>;
+    using group_type = CGGroup<real_type>;
+    using bead_ptr   = typename chain_type::bead_ptr;
+
+  public:
+
+    template<typename Comment, template<typename...> class Map,
+             template<typename...> class Array>
+    EnsembleGoContact(const toml::basic_value<Comment, Map, Array>& para,
+                      const std::size_t num_threads)
+        : coef_contact_     (toml::find<real_type>(para, "coef_contact")),
+          contact_threshold_(toml::find<real_type>(para, "contact_threshold")),
+          min_separation_   (toml::find_or<std::size_t>(para, "min_separation", 4)),
+          num_threads_      (num_threads)
+    {}
+
+    // `models` should have the same beads as `reference`.
+    ForceField<realT>&
+    generate(ForceField<realT>& out, const group_type& reference,
+             const std::vector<std::reference_wrapper<const group_type>>& models) const
+    {
+        using value_type = typename ForceField<real_type>::value_type;
+        using param_type = ParameterTable<real_type>;
+
+        if(models.empty()) {return out;}
+
+        std::map<std::size_t, bead_ptr> beads; // CGBead::index -> bead
+        for(const auto& chain : reference)
+        {
+            for(const auto& bead : chain)
+            {
+                beads[bead->index()] = bead;
+            }
+        }
+        const auto contacts = ensemble_contacts(models, this->contact_threshold_,
+                this->min_separation_, this->num_threads_);
+
+        auto& params = out.find_or_push_local(value_type{
+            {"interaction", "BondLength"},
+            {"potential",   "GoContact"},
+            {"topology",    "contact"}
+        }, /* the keys that should be equivalent = */ {
+            "interaction", "potential", "topology"
+        }, param_type(2, {"v0", "k"}));
+
+        log::info("generating Go Contact parameters of group ", reference.name(),
+                  " weighted over ", models.size(), " models.\n");
+        const std::size_t first = params.size();
+        for(const auto& contact : contacts)
+        {
+            const auto found1 = beads.find(contact.index1);
+            const auto found2 = beads.find(contact.index2);
+            if(found1 == beads.end() || found2 == beads.end())
+            {
+                log::error("EnsembleGoContact: models of group ", reference.name(),
+                           " have beads that are not in the reference\n");
+                std::terminate();
+            }
+            const auto& bead1 = found1->second;
+            const auto& bead2 = found2->second;
+            if(is_in_flexible_region(bead1) || is_in_flexible_region(bead2))
+            {
+                continue;
+            }
+            params.push_back({bead1->index(), bead2->index()},
+                {distance(bead1->position(), bead2->position()),
+                 -this->coef_contact_ * contact.frequency});
+        }
+        // if no contact is found, the comment should not be attached to the
+        // parameters appended later.
+        if(first != params.size())
+        {
+            params.add_comment(first, " Go Contact Potential in group " +
+                reference.name() + " weighted over " +
+                std::to_string(models.size()) + " models");
+        }
+        return out;
+    }
+
+  private:
+
+    bool is_in_flexible_region(const bead_ptr& bead) const
+    {
+        return bead->has_attribute("flexible_regions");
+    }
+
+  private:
+
+    real_type   coef_contact_;
+    real_type   contact_threshold_;
+    std::size_t min_separation_;
+    std::size_t num_threads_;
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_FORCEFIELD_ENSEMBLE_GO_CONTACT_HPP
@@ -26,12 +26,11 @@ class ExcludedVolume final : public ForceFieldGenerator<realT>
     {}
     ~ExcludedVolume() override = default;
 
-    toml::basic_value<toml::preserve_comments, std::map>&
-    generate(toml::basic_value<toml::preserve_comments, std::map>& out,
-             const group_type& chains) const override;
+    ForceField<realT>&
+    generate(ForceField<realT>& out, const group_type& chains) const override;
 
-    toml::basic_value<toml::preserve_comments, std::map>&
-    generate(toml::basic_value<toml::preserve_comments, std::map>& out,
+    ForceField<realT>&
+    generate(ForceField<realT>& out,
              const std::vector<std::reference_wrapper<const group_type>>& gs
              ) const override;
 
@@ -47,10 +46,8 @@ class ExcludedVolume final : public ForceFieldGenerator<realT>
 };
 
 template<typename realT>
-toml::basic_value<toml::preserve_comments, std::map>&
-ExcludedVolume<realT>::generate(
-        toml::basic_value<toml::preserve_comments, std::map>& ff_,
-        const group_type& chains) const
+ForceField<realT>&
+ExcludedVolume<realT>::generate(ForceField<realT>& ff, const group_type& chains) const
 {
     throw std::runtime_error("ExcludedVolume is global-only potential");
 //     using value_type = toml::basic_value<toml::preserve_comments, std::map>;
@@ -103,27 +100,15 @@ ExcludedVolume<realT>::generate(
 }
 
 template<typename realT>
-toml::basic_value<toml::preserve_comments, std::map>&
-ExcludedVolume<realT>::generate(
-    toml::basic_value<toml::preserve_comments, std::map>& ff_,
+ForceField<realT>&
+ExcludedVolume<realT>::generate(ForceField<realT>& ff,
     const std::vector<std::reference_wrapper<const group_type>>& groups) const
 {
-    using value_type = toml::basic_value<toml::preserve_comments, std::map>;
-    using array_type = value_type::array_type;
-    using table_type = value_type::table_type;
+    using value_type = typename ForceField<real_type>::value_type;
+    using table_type = typename value_type::table_type;
+    using param_type = ParameterTable<real_type>;
 
-    if(ff_.is_uninitialized())
-    {
-        ff_ = table_type{};
-    }
-
-    table_type& ff = ff_.as_table();
-    if(ff.count("global") == 0)
-    {
-        ff["global"] = array_type{};
-    }
-
-    table_type exv{
+    value_type exv{
         {"interaction", "Pair"          },
         {"potential"  , "ExcludedVolume"},
         // TODO: input ignore particles
@@ -138,24 +123,18 @@ ExcludedVolume<realT>::generate(
         {"epsilon", this->epsilon_}
     };
 
-    array_type params;
+    auto& params = ff.push_global(std::move(exv), param_type(1, {"radius"}));
     for(const auto& group : groups)
     {
         for(const auto& chain : group.get())
         {
             for(const auto& bead : chain)
             {
-                table_type para;
-                para["index"]  = bead->index();
-                para["radius"] = this->radii_.at(bead->name());
-                params.push_back(std::move(para));
+                params.push_back({bead->index()}, {this->radii_.at(bead->name())});
             }
         }
     }
-    exv["parameters"] = std::move(params);
-
-    ff.at("global").as_array().push_back(std::move(exv));
-    return ff_;
+    return ff;
 }
 
 } // jarngreipr
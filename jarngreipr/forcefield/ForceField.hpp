@@ -0,0 +1,107 @@
+#ifndef JARNGREIPR_FORCEFIELD_FORCEFIELD_HPP
+#define JARNGREIPR_FORCEFIELD_FORCEFIELD_HPP
+#include <jarngreipr/forcefield/ParameterTable.hpp>
+#include <jarngreipr/util/log.hpp>
+#include <extlib/toml/toml.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace jarngreipr
+{
+
+// a [[forcefields.local]] or [[forcefields.global]] table.
+// `header` has the keys except `parameters`, e.g. interaction, potential, env.
+template<typename realT>
+struct ForceFieldTable
+{
+    using value_type = toml::basic_value<toml::preserve_comments, std::map>;
+
+    value_type             header;
+    ParameterTable<realT>  parameters;
+};
+
+// parameters generated by ForceFieldGenerators.
+template<typename realT>
+class ForceField
+{
+  public:
+    using real_type  = realT;
+    using value_type = toml::basic_value<toml::preserve_comments, std::map>;
+    using table_type = ForceFieldTable<real_type>;
+
+  public:
+
+    // It is inefficient to define multiple LocalForceFiled having the same
+    // combination of interaction and potential. If a table that has the same
+    // values of `keys` as `header` exists, return its parameters. Otherwise,
+    // push a new table that has the same keys as `params`.
+    ParameterTable<real_type>&
+    find_or_push_local(const value_type& header, const std::vector<std::string>& keys,
+                       const ParameterTable<real_type>& params)
+    {
+        return find_or_push(this->local_, header, keys, params);
+    }
+    ParameterTable<real_type>&
+    find_or_push_global(const value_type& header, const std::vector<std::string>& keys,
+                        const ParameterTable<real_type>& params)
+    {
+        return find_or_push(this->global_, header, keys, params);
+    }
+
+    ParameterTable<real_type>& push_local(value_type header, ParameterTable<real_type> params)
+    {
+        this->local_.push_back(table_type{std::move(header), std::move(params)});
+        return this->local_.back().parameters;
+    }
+    ParameterTable<real_type>& push_global(value_type header, ParameterTable<real_type> params)
+    {
+        this->global_.push_back(table_type{std::move(header), std::move(params)});
+        return this->global_.back().parameters;
+    }
+
+    std::vector<table_type> const& local()  const noexcept {return local_;}
+    std::vector<table_type> const& global() const noexcept {return global_;}
+
+  private:
+
+    static ParameterTable<real_type>&
+    find_or_push(std::vector<table_type>& tables, const value_type& header,
+                 const std::vector<std::string>& keys,
+                 const ParameterTable<real_type>& params)
+    {
+        const auto found = std::find_if(tables.begin(), tables.end(),
+            [&](const table_type& t) -> bool {
+                for(const auto& key : keys)
+                {
+                    if(!t.header.contains(key) || !header.contains(key) ||
+                       t.header.at(key) != header.at(key))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            });
+        if(found == tables.end())
+        {
+            tables.push_back(table_type{header, params.empty_copy()});
+            return tables.back().parameters;
+        }
+        if(!found->parameters.has_same_keys(params))
+        {
+            log::error("ForceField: tables of the same potential have "
+                       "parameters with different keys\n");
+            std::terminate();
+        }
+        return found->parameters;
+    }
+
+  private:
+
+    std::vector<table_type> local_;
+    std::vector<table_type> global_;
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_FORCEFIELD_FORCEFIELD_HPP
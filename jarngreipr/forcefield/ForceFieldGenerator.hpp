@@ -1,7 +1,10 @@
 #ifndef JARNGREIPR_FORCEFIELD_GENERATOR
 #define JARNGREIPR_FORCEFIELD_GENERATOR
 #include <jarngreipr/model/CGGroup.hpp>
+#include <jarngreipr/forcefield/ForceField.hpp>
+#include <jarngreipr/util/thread_pool.hpp>
 #include <extlib/toml/toml.hpp>
+#include <algorithm>
 #include <memory>
 #include <map>
 
@@ -19,97 +22,45 @@ class ForceFieldGenerator
     using atom_type  = typename bead_type::atom_type;
 
   public:
+    ForceFieldGenerator(): pool_(new ThreadPool(1)) {}
     virtual ~ForceFieldGenerator() = default;
 
     //!@brief generate forcefield parameter values
-    virtual toml::basic_value<toml::preserve_comments, std::map>&
-    generate(toml::basic_value<toml::preserve_comments, std::map>& out,
-             const group_type& group) const = 0;
+    //!@note generate() uses the thread pool of the generator that runs one
+    //!      job at a time. A generator should not be used from several
+    //!      threads at once, even though generate() is const.
+    virtual ForceField<real_type>&
+    generate(ForceField<real_type>& out, const group_type& group) const = 0;
 
     //!@brief generate inter-chain parameters if it's defined.
-    virtual toml::basic_value<toml::preserve_comments, std::map>&
-    generate(toml::basic_value<toml::preserve_comments, std::map>& out,
+    virtual ForceField<real_type>&
+    generate(ForceField<real_type>& out,
              const std::vector<std::reference_wrapper<const group_type>>& gs
              ) const = 0;
 
     //!@brief if chain contains invalid bead, return false.
     virtual bool check_beads_kind(const chain_type& chain) const = 0;
-};
-
-// It is inefficient to define multiple LocalForceFiled having the same
-// combination of interaction and potential.
-//
-// This comparator finds a table that has the same combination as the reference
-// table value. It is helpful to merge two (semantically the same) tables.
-//
-template<typename Value>
-struct toml_table_comparator
-{
-    using value_type = Value; // toml::basic_value<...>
-
-    value_type reference;
-    std::vector<std::string> keys; // keys to compare
 
-    toml_table_comparator(value_type r, std::vector<std::string> ks)
-        : reference(std::move(r)), keys(std::move(ks))
+    //!@brief number of threads used to search contacts. 1 by default.
+    std::size_t num_threads() const noexcept {return pool_->size();}
+    void set_num_threads(const std::size_t n)
     {
-        if(!r.is_table())
+        if(n != pool_->size())
         {
-            throw std::invalid_argument("reference toml value is not a table");
+            this->pool_.reset(new ThreadPool(n));
         }
     }
 
-    bool operator()(const value_type& other) noexcept
-    {
-        // check "interaction", "potential" and "topology".
-        try
-        {
-            const auto& t1 = reference.as_table();
-            const auto& t2 = other.as_table();
-            for(const auto& key : keys)
-            {
-                if(t1.at(key) != t2.at(key))
-                {
-                    return false;
-                }
-            }
-            return true;
-        }
-        catch(...) {return false;}
-    };
-};
+  protected:
 
-template<typename Comment, template<typename...> class Map,
-         template<typename...> class Array>
-toml_table_comparator<toml::basic_value<Comment, Map, Array>>
-make_table_comparator(const toml::basic_value<Comment, Map, Array>& tab,
-                      std::vector<std::string> keys)
-{
-    return toml_table_comparator<toml::basic_value<Comment, Map, Array>>(
-            tab, std::move(keys));
-}
+    // threads are started once and shared by all the loops in generate().
+    // It is shared even through a const generator; see the note on generate().
+    ThreadPool& thread_pool() const noexcept {return *pool_;}
 
-// search a table.
-// If a table that is equivalent to`src` exists in a table `dst`,
-// return a reference to it.
-// Otherwise, push `src` and return a reference to the newly created one.
-template<typename Comment, template<typename...> class Map,
-         template<typename...> class Array>
-toml::basic_value<Comment, Map, Array>&
-find_or_push_table(toml::basic_value<Comment, Map, Array>& dst,
-                   const toml::basic_value<Comment, Map, Array>& src,
-                   std::vector<std::string> keys)
-{
-    const auto cmp = make_table_comparator(src, std::move(keys));
-    auto& dst_array = dst.as_array();
-    const auto found = std::find_if(dst_array.begin(), dst_array.end(), cmp);
-    if(dst_array.end() == found)
-    {
-        dst_array.push_back(src);
-        return dst_array.back();
-    }
-    return *found;
-}
+  private:
+
+    std::unique_ptr<ThreadPool> pool_;
+};
 
 } // mjolnir
 #endif// JARNGREIPR_FORCEFIELD_GENERATOR
@@ -2,11 +2,15 @@
 #define JARNGREIPR_FORCEFIELD_GO_CONTACT_HPP
 #include <extlib/toml/toml.hpp>
 #include <jarngreipr/forcefield/ForceFieldGenerator.hpp>
+#include <jarngreipr/forcefield/make_cell_list.hpp>
+#include <jarngreipr/forcefield/inter_chain_contacts.hpp>
 #include <jarngreipr/geometry/distance.hpp>
+#include <jarngreipr/geometry/min_distance.hpp>
 #include <jarngreipr/util/log.hpp>
 #include <iterator>
 #include <iostream>
 #include <vector>
+#include <set>
 
 namespace jarngreipr
 {
@@ -33,92 +37,77 @@ class GoContact final : public ForceFieldGenerator<realT>
     ~GoContact() override = default;
 
     // generate intra-chain contacts.
-    toml::basic_value<toml::preserve_comments, std::map>&
-    generate(toml::basic_value<toml::preserve_comments, std::map>& out,
-             const group_type& group) const override
+    ForceField<realT>&
+    generate(ForceField<realT>& out, const group_type& group) const override
     {
-        using value_type = toml::basic_value<toml::preserve_comments, std::map>;
-        using array_type = value_type::array_type;
-        using table_type = value_type::table_type;
-
-        if(out.is_uninitialized())
-        {
-            out = table_type{};
-        }
-        if(!out.contains("local"))
-        {
-            out["local"] = array_type{};
-        }
+        using value_type = typename ForceField<real_type>::value_type;
+        using param_type = ParameterTable<real_type>;
 
         const auto th2 = this->contact_threshold_ * this->contact_threshold_;
 
-        auto& params = find_or_push_table(out.at("local"), value_type{
+        auto& params = out.find_or_push_local(value_type{
             {"interaction", "BondLength"},
             {"potential",   "GoContact"},
-            {"topology",    "contact"},
-            {"parameters",  array_type{}}
+            {"topology",    "contact"}
         }, /* the keys that should be equivalent = */ {
             "interaction", "potential", "topology"
-        }).as_table().at("parameters").as_array();
+        }, param_type(2, {"v0", "k"}));
+
+        // bead j in chain k has ID `chain_offsets.at(k) + j` in the cell list.
+        const auto cell_list = make_cell_list(
+            std::vector<std::reference_wrapper<const chain_type>>(
+                group.begin(), group.end()), this->contact_threshold_);
+        std::vector<std::size_t> chain_offsets(1, 0);
+        for(const auto& chain : group)
+        {
+            chain_offsets.push_back(chain_offsets.back() + chain.size());
+        }
+
+        const auto contacts = find_inter_chain_contacts(this->thread_pool(),
+            cell_list, chain_offsets,
+            [](const std::size_t, const std::size_t) noexcept {return true;},
+            [&](const std::size_t chain_i, const std::size_t idx1,
+                const std::size_t chain_j, const std::size_t idx2
+                ) -> std::pair<bool, real_type> {
+                const auto& bead1 = group.at(chain_i).at(idx1);
+                const auto& bead2 = group.at(chain_j).at(idx2);
+                if(is_in_flexible_region(bead1) || is_in_flexible_region(bead2))
+                {
+                    return std::make_pair(false, real_type(0));
+                }
+                return std::make_pair(this->is_in_contact(bead1, bead2, th2),
+                                      -this->coef_contact_);
+            });
 
         for(std::size_t chain_i = 0; chain_i < group.size(); ++chain_i)
         {
             const auto& chain1 = group.at(chain_i);
-
-            for(std::size_t chain_j=chain_i+1; chain_j<group.size(); ++chain_j)
+            const auto& found  = contacts.at(chain_i);
+            for(auto first = found.begin(); first != found.end();)
             {
-                const auto& chain2 = group.at(chain_j);
+                const auto& chain2 = group.at(first->partner);
+                const auto  last   = contacts_with(found, first->partner).second;
 
                 log::info("generating Go Contact parameters between ", chain1.name(),
                           " and ", chain2.name(), " with coefficient ", this->coef_contact_, ".\n");
 
-                bool is_first = true; // gen comment about chain name
-                for(const auto& bead1 : chain1)
-                {
-                    if(is_in_flexible_region(bead1)) {continue;}
-
-                    for(const auto& bead2 : chain2)
-                    {
-                        if(is_in_flexible_region(bead2)) {continue;}
-
-                        if(this->min_distance_sq(bead1, bead2) < th2)
-                        {
-                            const auto i1 = bead1->index();
-                            const auto i2 = bead2->index();
-
-                            const auto nat_dist =
-                                distance(bead1->position(), bead2->position());
-
-                            value_type para = table_type{
-                                {"indices", value_type{i1, i2}  },
-                                {"v0"     , nat_dist            },
-                                {"k"      , -this->coef_contact_}
-                            };
-                            if(is_first)
-                            {
-                                para.comments().push_back(std::string(" Go "
-                                    "Contact Potential between chain ") +
-                                    chain1.name() + " and " + chain2.name());
-                                is_first = false;
-                            }
-                            params.push_back(std::move(para));
-                        }
-                    }
-                }
+                append_contacts(params, chain1, chain2, first, last,
+                    std::string(" Go Contact Potential between chain ") +
+                    chain1.name() + " and " + chain2.name());
+                first = last;
             }
         }
         return out;
     }
 
     // generate inter-chain contacts.
-    toml::basic_value<toml::preserve_comments, std::map>&
-    generate(toml::basic_value<toml::preserve_comments, std::map>& out,
+    ForceField<realT>&
+    generate(ForceField<realT>& out,
              const std::vector<std::reference_wrapper<const group_type>>& gs
              ) const override
     {
-        using value_type = toml::basic_value<toml::preserve_comments, std::map>;
-        using array_type = value_type::array_type;
-        using table_type = value_type::table_type;
+        using value_type = typename ForceField<real_type>::value_type;
+        using param_type = ParameterTable<real_type>;
 
         log::debug("generating inter-chain AICG2+ parameters\n");
         for(const auto& g : gs)
@@ -126,27 +115,56 @@ class GoContact final : public ForceFieldGenerator<realT>
             log::debug("- ", g.get().name(), "\n");
         }
 
-        if(out.is_uninitialized())
-        {
-            out = table_type{};
-        }
-        if(!out.contains("local"))
-        {
-            out["local"] = array_type{};
-        }
-
         const auto th2 = this->contact_threshold_ * this->contact_threshold_;
 
-        auto& params = find_or_push_table(out.at("local"), value_type{
+        auto& params = out.find_or_push_local(value_type{
             {"interaction", "BondLength"},
             {"potential",   "GoContact"},
-            {"topology",    "contact"},
-            {"parameters",  array_type{}}
+            {"topology",    "contact"}
         }, /* the keys that should be equivalent = */ {
             "interaction", "potential", "topology"
-        }).as_table().at("parameters").as_array();
+        }, param_type(2, {"v0", "k"}));
+
+        // the c-th chain of the g-th group is `all_chains.at(first_chain.at(g) + c)`
+        // and its k-th bead has ID `chain_offsets.at(first_chain.at(g) + c) + k`
+        std::vector<std::reference_wrapper<const chain_type>> all_chains;
+        std::vector<std::size_t> group_of;
+        std::vector<std::size_t> first_chain;
+        std::vector<std::size_t> chain_offsets(1, 0);
+        for(std::size_t g=0; g<gs.size(); ++g)
+        {
+            first_chain.push_back(all_chains.size());
+            for(const auto& chain : gs.at(g).get())
+            {
+                all_chains.push_back(std::cref(chain));
+                group_of.push_back(g);
+                chain_offsets.push_back(chain_offsets.back() + chain.size());
+            }
+        }
+        const auto cell_list = make_cell_list(all_chains, this->contact_threshold_);
+
+        const auto contacts = find_inter_chain_contacts(this->thread_pool(),
+            cell_list, chain_offsets,
+            [&](const std::size_t c1, const std::size_t c2) -> bool {
+                return group_of.at(c1) != group_of.at(c2) &&
+                       all_chains.at(c1).get().name() != all_chains.at(c2).get().name();
+            },
+            [&](const std::size_t c1, const std::size_t idx1,
+                const std::size_t c2, const std::size_t idx2
+                ) -> std::pair<bool, real_type> {
+                const auto& bead1 = all_chains.at(c1).get().at(idx1);
+                const auto& bead2 = all_chains.at(c2).get().at(idx2);
+                // if one of the bead is flexible region, skip it.
+                if(is_in_flexible_region(bead1) || is_in_flexible_region(bead2))
+                {
+                    return std::make_pair(false, real_type(0));
+                }
+                return std::make_pair(this->is_in_contact(bead1, bead2, th2),
+                                      -this->coef_contact_);
+            });
 
-        std::vector<std::pair<std::string, std::string>> combinations;
+        // pairs of chain names already generated, stored as {min, max}
+        std::set<std::pair<std::string, std::string>> combinations;
 
         for(std::size_t i=0; i<gs.size(); ++i)
         {
@@ -154,60 +172,38 @@ class GoContact final : public ForceFieldGenerator<realT>
             for(std::size_t j=i+1; j<gs.size(); ++j)
             {
                 const auto& rhs = gs.at(j).get();
-                for(const auto& chain1 : lhs)
+                for(std::size_t chain_i=0; chain_i<lhs.size(); ++chain_i)
                 {
-                    for(const auto& chain2 : rhs)
+                    const auto& chain1 = lhs.at(chain_i);
+                    const auto& found  = contacts.at(first_chain.at(i) + chain_i);
+                    for(std::size_t chain_j=0; chain_j<rhs.size(); ++chain_j)
                     {
+                        const auto& chain2 = rhs.at(chain_j);
+
                         if(chain1.name() == chain2.name())
                         {
                             continue;
                         }
                         // combination already found
-                        if(std::find_if(combinations.begin(), combinations.end(),
-                            [&](const std::pair<std::string, std::string>& c){
-                                return (c.first == chain2.name() && c.second == chain1.name()) ||
-                                       (c.first == chain1.name() && c.second == chain2.name());
-                            }) != combinations.end())
+                        if(!combinations.insert(std::make_pair(
+                                std::min(chain1.name(), chain2.name()),
+                                std::max(chain1.name(), chain2.name()))).second)
                         {
                             continue;
                         }
-                        combinations.push_back(std::make_pair(chain1.name(), chain2.name()));
 
+                        const auto range = contacts_with(found, first_chain.at(j) + chain_j);
+                        if(range.first == range.second)
+                        {
+                            continue;
+                        }
                         log::info("generating Go Contact parameters between chain ",
                                   chain1.name(), " and ", chain2.name(), " using coefficient ",
                                   this->coef_contact_, ".\n");
 
-                        bool is_first = true;
-                        for(const auto& bead1 : chain1)
-                        {
-                            for(const auto& bead2 : chain2)
-                            {
-                                if(this->min_distance_sq(bead1, bead2) < th2)
-                                {
-                                    const auto i1 = bead1->index();
-                                    const auto i2 = bead2->index();
-
-                                    // if one of the bead is flexible region, continue.
-                                    if(is_in_flexible_region(bead1) || is_in_flexible_region(bead2))
-                                    {
-                                        continue;
-                                    }
-
-                                    value_type para = table_type{
-                                        {"indices", value_type{i1, i2}},
-                                        {"v0"     , distance(bead1->position(), bead2->position())},
-                                        {"k"      , -coef_contact_}
-                                    };
-                                    if(is_first)
-                                    {
-                                        para.comments().push_back(" Go Contact Potential "
-                                            "between chain " + chain1.name() + " and chain " + chain2.name());
-                                        is_first = false;
-                                    }
-                                    params.push_back(std::move(para));
-                                }
-                            }
-                        }
+                        append_contacts(params, chain1, chain2, range.first, range.second,
+                            " Go Contact Potential between chain " + chain1.name() +
+                            " and chain " + chain2.name());
                     }
                 }
             }
@@ -223,18 +219,11 @@ class GoContact final : public ForceFieldGenerator<realT>
     {
         return bead->has_attribute("flexible_regions");
     }
-    real_type min_distance_sq(const bead_ptr& bead1, const bead_ptr& bead2) const
+    bool is_in_contact(const bead_ptr& bead1, const bead_ptr& bead2,
+                       const real_type threshold_sq) const
     {
-        real_type min_dist_sq = std::numeric_limits<real_type>::max();
-        for(const auto& atom1 : remove_hydrogens(bead1->atoms()))
-        {
-            for(const auto& atom2 : remove_hydrogens(bead2->atoms()))
-            {
-                const auto dsq = distance_sq(atom1.position, atom2.position);
-                min_dist_sq = std::min(dsq, min_dist_sq);
-            }
-        }
-        return min_dist_sq;
+        return any_pair_within(bead1->heavy_positions(),
+                               bead2->heavy_positions(), threshold_sq);
     }
 
   private:
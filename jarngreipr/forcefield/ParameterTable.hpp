@@ -0,0 +1,177 @@
+#ifndef JARNGREIPR_FORCEFIELD_PARAMETER_TABLE_HPP
+#define JARNGREIPR_FORCEFIELD_PARAMETER_TABLE_HPP
+#include <jarngreipr/util/log.hpp>
+#include <initializer_list>
+#include <algorithm>
+#include <utility>
+#include <string>
+#include <vector>
+
+namespace jarngreipr
+{
+
+//
+// Parameters of a forcefield table stored column-wise.
+//
+// Every parameter has the same number of indices and the same keys, e.g.
+// `{indices = [i, j], k = ..., v0 = ...}`, so only the values are stored. A key
+// of a value in an inline table is written as "Gaussian.k". A contact takes
+// 2 indices and 2 reals instead of a tree of toml::basic_values.
+//
+template<typename realT>
+class ParameterTable
+{
+  public:
+    using real_type = realT;
+
+  public:
+
+    ParameterTable(): arity_(0), max_index_(0) {}
+    ParameterTable(const std::size_t arity, std::vector<std::string> real_keys,
+                   std::vector<std::string> string_keys = {})
+        : arity_(arity), max_index_(0), real_keys_(std::move(real_keys)),
+          string_keys_(std::move(string_keys))
+    {}
+
+    // the same keys, but no parameter.
+    ParameterTable empty_copy() const
+    {
+        return ParameterTable(arity_, real_keys_, string_keys_);
+    }
+    bool has_same_keys(const ParameterTable& other) const noexcept
+    {
+        return this->arity_       == other.arity_     &&
+               this->real_keys_   == other.real_keys_ &&
+               this->string_keys_ == other.string_keys_;
+    }
+
+    void push_back(std::initializer_list<std::size_t> indices,
+                   std::initializer_list<real_type>   reals,
+                   std::initializer_list<std::string> strings = {})
+    {
+        if(indices.size() != arity_ || reals.size() != real_keys_.size() ||
+           strings.size() != string_keys_.size())
+        {
+            log::error("ParameterTable: number of values does not match\n");
+            std::terminate();
+        }
+        for(const auto idx : indices)
+        {
+            max_index_ = std::max(max_index_, idx);
+            indices_.push_back(idx);
+        }
+        reals_  .insert(reals_  .end(), reals  .begin(), reals  .end());
+        strings_.insert(strings_.end(), strings.begin(), strings.end());
+        return;
+    }
+
+    // append parameters in `other` with indices shifted by `shift`.
+    void append(const ParameterTable& other, const std::size_t shift = 0,
+                const bool with_comments = true)
+    {
+        if(!this->has_same_keys(other))
+        {
+            log::error("ParameterTable: cannot append parameters that have "
+                       "different keys\n");
+            std::terminate();
+        }
+        const std::size_t first = this->size();
+        for(const auto idx : other.indices_)
+        {
+            indices_.push_back(idx + shift);
+        }
+        if(!other.indices_.empty())
+        {
+            max_index_ = std::max(max_index_, other.max_index_ + shift);
+        }
+        reals_  .insert(reals_  .end(), other.reals_  .begin(), other.reals_  .end());
+        strings_.insert(strings_.end(), other.strings_.begin(), other.strings_.end());
+        if(with_comments)
+        {
+            for(const auto& c : other.comments_)
+            {
+                comments_.emplace_back(first + c.first, c.second);
+            }
+        }
+        return;
+    }
+
+    // comments are written before the `i`-th parameter.
+    void add_comment(const std::size_t i, std::string comment)
+    {
+        const auto pos = std::upper_bound(comments_.begin(), comments_.end(), i,
+            [](const std::size_t lhs, const std::pair<std::size_t, std::string>& rhs) {
+                return lhs < rhs.first;
+            });
+        comments_.emplace(pos, i, std::move(comment));
+        return;
+    }
+
+    std::size_t size() const noexcept
+    {
+        if(arity_ != 0)             {return indices_.size() / arity_;}
+        if(!real_keys_.empty())     {return reals_.size()   / real_keys_.size();}
+        if(!string_keys_.empty())   {return strings_.size() / string_keys_.size();}
+        return 0;
+    }
+    bool empty() const noexcept {return this->size() == 0;}
+
+    std::size_t arity() const noexcept {return arity_;}
+
+    // the largest index, used to align the indices in the output.
+    std::size_t max_index() const noexcept {return max_index_;}
+    std::vector<std::string> const& real_keys()   const noexcept {return real_keys_;}
+    std::vector<std::string> const& string_keys() const noexcept {return string_keys_;}
+
+    std::size_t index(const std::size_t i, const std::size_t k) const noexcept
+    {
+        return indices_[i * arity_ + k];
+    }
+    real_type real(const std::size_t i, const std::size_t k) const noexcept
+    {
+        return reals_[i * real_keys_.size() + k];
+    }
+    std::string const& string(const std::size_t i, const std::size_t k) const noexcept
+    {
+        return strings_[i * string_keys_.size() + k];
+    }
+
+    // sorted by the index of parameters.
+    std::vector<std::pair<std::size_t, std::string>> const&
+    comments() const noexcept {return comments_;}
+
+  private:
+
+    std::size_t              arity_;
+    std::size_t              max_index_;
+    std::vector<std::string> real_keys_;
+    std::vector<std::string> string_keys_;
+
+    std::vector<std::size_t> indices_;
+    std::vector<real_type>   reals_;
+    std::vector<std::string> strings_;
+    std::vector<std::pair<std::size_t, std::string>> comments_;
+};
+
+// append parameters that are generated row by row (possibly in parallel).
+// Rows are concatenated in order, so the result does not depend on the number
+// of threads. `comment` is attached to the first parameter if there is any.
+template<typename realT>
+void append_rows(ParameterTable<realT>& dst,
+                 const std::vector<ParameterTable<realT>>& rows,
+                 std::string comment)
+{
+    const std::size_t first = dst.size();
+    for(const auto& row : rows)
+    {
+        dst.append(row);
+    }
+    if(first != dst.size())
+    {
+        dst.add_comment(first, std::move(comment));
+    }
+    return;
+}
+
+} // jarngreipr
+#endif// JARNGREIPR_FORCEFIELD_PARAMETER_TABLE_HPP
@@ -0,0 +1,133 @@
+#ifndef JARNGREIPR_FORCEFIELD_ENSEMBLE_CONTACTS_HPP
+#define JARNGREIPR_FORCEFIELD_ENSEMBLE_CONTACTS_HPP
+#include <jarngreipr/forcefield/make_cell_list.hpp>
+#include <jarngreipr/geometry/min_distance.hpp>
+#include <jarngreipr/model/CGGroup.hpp>
+#include <jarngreipr/util/log.hpp>
+#include <jarngreipr/util/parallel_for.hpp>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace jarngreipr
+{
+
+// a pair of beads that are in contact in some of the models.
+template<typename realT>
+struct EnsembleContact
+{
+    std::size_t index1;    // bead index (CGBead::index) of the first model
+    std::size_t index2;    // index1 < index2
+    realT       frequency; // fraction of the models in which they contact
+};
+
+// contact map averaged over an ensemble, e.g. the models of an NMR structure.
+//
+// All the groups should have the same chains and beads in the same order,
+// i.e. they are generated from the models of the same structure. Two beads
+// are in contact if any pair of their heavy atoms is within the threshold.
+// Pairs in the same chain are ignored if they are closer than
+// `min_separation` in the sequence.
+//
+// Each model is processed in a separate thread, and the result is sorted by
+// the indices, so it does not depend on the number of threads.
+template<typename realT>
+std::vector<EnsembleContact<realT>>
+ensemble_contacts(const std::vector<std::reference_wrapper<const CGGroup<realT>>>& models,
+                  const realT threshold, const std::size_t min_separation,
+                  const std::size_t num_threads)
+{
+    using chain_type = CGChain<realT>;
+    using pair_type  = std::pair<std::size_t, std::size_t>;
+
+    if(models.empty()) {return {};}
+
+    // beads are identified by their serial index through the chains, as
+    // make_cell_list does. chain_of[i] is the chain that has the i-th bead.
+    const auto& reference = models.front().get();
+    std::vector<std::size_t> chain_of;
+    for(std::size_t c=0; c<reference.size(); ++c)
+    {
+        chain_of.insert(chain_of.end(), reference.at(c).size(), c);
+    }
+    for(const auto& model : models)
+    {
+        bool same_topology = (model.get().size() == reference.size());
+        for(std::size_t c=0; same_topology && c<reference.size(); ++c)
+        {
+            same_topology = (model.get().at(c).size() == reference.at(c).size());
+        }
+        if(!same_topology)
+        {
+            log::error("ensemble_contacts: model ", model.get().name(),
+                       " has different chains from ", reference.name(), '\n');
+            std::terminate();
+        }
+    }
+
+    const auto th2 = threshold * threshold;
+    std::vector<std::vector<pair_type>> contacts(models.size());
+    parallel_for(num_threads, 0, models.size(), [&](const std::size_t m) -> void {
+        const auto& group = models.at(m).get();
+        std::vector<std::reference_wrapper<const chain_type>> chains(
+                group.begin(), group.end());
+        std::vector<typename chain_type::bead_ptr> beads;
+        for(const auto& chain : group)
+        {
+            beads.insert(beads.end(), chain.begin(), chain.end());
+        }
+
+        const auto cell_list = make_cell_list(chains, threshold);
+        for(std::size_t i=0; i<beads.size(); ++i)
+        {
+            for(const auto j : cell_list.neighbors(i))
+            {
+                if(j <= i) {continue;}
+                if(chain_of[i] == chain_of[j] && j - i < min_separation)
+                {
+                    continue;
+                }
+                if(any_pair_within(beads[i]->heavy_positions(),
+                                   beads[j]->heavy_positions(), th2))
+                {
+                    contacts[m].emplace_back(i, j);
+                }
+            }
+        }
+        return;
+    });
+
+    // count the models in which each pair is in contact.
+    std::vector<pair_type> all;
+    for(const auto& c : contacts)
+    {
+        all.insert(all.end(), c.begin(), c.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    std::vector<std::size_t> index_of;
+    for(const auto& chain : reference)
+    {
+        for(const auto& bead : chain)
+        {
+            index_of.push_back(bead->index());
+        }
+    }
+
+    std::vector<EnsembleContact<realT>> retval;
+    for(auto iter = all.begin(); iter != all.end();)
+    {
+        const auto next  = std::upper_bound(iter, all.end(), *iter);
+        const auto count = static_cast<std::size_t>(std::distance(iter, next));
+        retval.push_back(EnsembleContact<realT>{
+            index_of.at(iter->first), index_of.at(iter->second),
+            static_cast<realT>(count) / static_cast<realT>(models.size())});
+        iter = next;
+    }
+    return retval;
+}
+
+} // jarngreipr
+#endif// JARNGREIPR_FORCEFIELD_ENSEMBLE_CONTACTS_HPP
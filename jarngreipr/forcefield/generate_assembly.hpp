@@ -0,0 +1,217 @@
+#ifndef JARNGREIPR_FORCEFIELD_GENERATE_ASSEMBLY_HPP
+#define JARNGREIPR_FORCEFIELD_GENERATE_ASSEMBLY_HPP
+#include <jarngreipr/forcefield/ForceFieldGenerator.hpp>
+#include <jarngreipr/geometry/rigid_copy.hpp>
+#include <jarngreipr/util/log.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace jarngreipr
+{
+
+namespace detail
+{
+// generate local parameters of `unit` once, and append them to `out` for each
+// of `shifts`, adding the shift to the indices. A shift of 0 is the unit itself.
+// `comments[k]` is attached to the first parameter of the k-th replica.
+template<typename realT>
+void stamp_local_parameters(const ForceFieldGenerator<realT>& gen,
+        ForceField<realT>& out, const CGGroup<realT>& unit,
+        const std::vector<std::size_t>& shifts,
+        const std::vector<std::string>& comments)
+{
+    ForceField<realT> unit_ff;
+    gen.generate(unit_ff, unit);
+
+    if(!unit_ff.global().empty())
+    {
+        log::error("global forcefield cannot be replicated\n");
+        std::terminate();
+    }
+    for(const auto& table : unit_ff.local())
+    {
+        // a generator may distinguish tables by any key in the header, e.g.
+        // "env" of AICG2+ that depends on the parameter file. So the whole
+        // header should match.
+        std::vector<std::string> keys;
+        for(const auto& kv : table.header.as_table())
+        {
+            keys.push_back(kv.first);
+        }
+        auto& params = out.find_or_push_local(table.header, keys, table.parameters);
+
+        const auto& unit_params = table.parameters;
+        for(std::size_t k=0; k<shifts.size(); ++k)
+        {
+            const auto shift = shifts.at(k);
+            const auto first = params.size();
+            params.append(unit_params, shift, /* with_comments = */ shift == 0);
+            if(shift != 0 && !unit_params.empty())
+            {
+                params.add_comment(first, comments.at(k));
+            }
+        }
+    }
+    return;
+}
+
+// `rhs` has the same parameters as `lhs` with indices shifted by `shift`.
+template<typename realT>
+bool is_replica(const CGChain<realT>& lhs, const CGChain<realT>& rhs,
+                const std::size_t shift, const realT tolerance)
+{
+    using coordinate_type = typename CGBead<realT>::coordinate_type;
+    if(lhs.size() != rhs.size()) {return false;}
+
+    std::vector<coordinate_type> lpos, rpos;
+    for(std::size_t i=0; i<lhs.size(); ++i)
+    {
+        const auto& l = lhs.at(i);
+        const auto& r = rhs.at(i);
+        if(l->index() + shift != r->index() || l->kind() != r->kind() ||
+           l->name() != r->name() || l->mass() != r->mass() ||
+           l->attributes() != r->attributes() ||
+           l->heavy_atom_classes() != r->heavy_atom_classes())
+        {
+            return false;
+        }
+        lpos.push_back(l->position());
+        rpos.push_back(r->position());
+        lpos.insert(lpos.end(), l->heavy_positions().begin(), l->heavy_positions().end());
+        rpos.insert(rpos.end(), r->heavy_positions().begin(), r->heavy_positions().end());
+    }
+    return is_rigid_copy(lpos, rpos, tolerance);
+}
+} // detail
+
+// generate local parameters of a group made by expand_assembly.
+//
+// All the copies have the same intra-copy parameters except for the indices,
+// so they are generated only for the first copy and replicated with shifted
+// indices. Interactions between copies are generated as inter-group
+// parameters, as if each copy were a group. If `inter_copy` is false, e.g. for
+// copies randomly packed in a box, they are not generated.
+//
+// `num_copies` copies of the same chains should be contiguous in `group`
+// and the k-th copy has indices shifted by `k * (beads in a copy)`.
+template<typename realT>
+ForceField<realT>&
+generate_assembly(const ForceFieldGenerator<realT>& gen, ForceField<realT>& out,
+                  const CGGroup<realT>& group, const std::size_t num_copies,
+                  const bool inter_copy = true)
+{
+    if(num_copies == 0 || group.size() % num_copies != 0)
+    {
+        log::error("generate_assembly: group ", group.name(), " has ",
+                   group.size(), " chains, not divisible by ", num_copies, '\n');
+        std::terminate();
+    }
+    const std::size_t chains_per_copy = group.size() / num_copies;
+
+    std::vector<CGGroup<realT>> copies(num_copies, CGGroup<realT>(group.name()));
+    for(std::size_t i=0; i<group.size(); ++i)
+    {
+        copies.at(i / chains_per_copy).push_back(group.at(i));
+    }
+    std::size_t beads_per_copy = 0;
+    for(const auto& chain : copies.front())
+    {
+        beads_per_copy += chain.size();
+    }
+    std::vector<std::size_t> shifts;
+    std::vector<std::string> comments;
+    for(std::size_t k=0; k<num_copies; ++k)
+    {
+        shifts.push_back(k * beads_per_copy);
+        comments.push_back(" copy " + std::to_string(k+1) + " of " +
+                           group.name() + ", the same as copy 1");
+    }
+    detail::stamp_local_parameters(gen, out, copies.front(), shifts, comments);
+    if(!inter_copy) {return out;}
+
+    std::vector<std::reference_wrapper<const CGGroup<realT>>> refs(
+            copies.begin(), copies.end());
+    gen.generate(out, refs);
+    return out;
+}
+
+// generate local parameters of a group that has identical chains, e.g. a
+// homo-oligomer.
+//
+// A chain is a replica of a former chain if their beads are the same and the
+// coordinates are the same within `tolerance` after superposition. Intra-chain
+// parameters are generated once for each set of replicas, and stamped with
+// shifted indices. Interactions between chains are generated as inter-group
+// parameters, as if each chain were a group. If no chain has a replica, it is
+// the same as `gen.generate(out, group)`.
+template<typename realT>
+ForceField<realT>&
+generate_replicated(const ForceFieldGenerator<realT>& gen, ForceField<realT>& out,
+                    const CGGroup<realT>& group, const realT tolerance)
+{
+    // each element is a list of {index of a chain, shift of the indices}.
+    // The first chain in the list is the original.
+    std::vector<std::vector<std::pair<std::size_t, std::size_t>>> replicas;
+    bool found = false;
+    for(std::size_t i=0; i<group.size(); ++i)
+    {
+        const auto& chain = group.at(i);
+        bool is_replica = false;
+        for(auto& rep : replicas)
+        {
+            const auto& original = group.at(rep.front().first);
+            if(chain.size() == 0 || original.size() == 0 ||
+               chain.at(0)->index() < original.at(0)->index())
+            {
+                continue;
+            }
+            const auto shift = chain.at(0)->index() - original.at(0)->index();
+            if(detail::is_replica(original, chain, shift, tolerance))
+            {
+                log::info("chain ", chain.name(), " is a replica of chain ",
+                          original.name(), '\n');
+                rep.emplace_back(i, shift);
+                is_replica = found = true;
+                break;
+            }
+        }
+        if(!is_replica)
+        {
+            replicas.push_back({std::make_pair(i, std::size_t(0))});
+        }
+    }
+    if(!found)
+    {
+        return gen.generate(out, group);
+    }
+
+    std::vector<CGGroup<realT>> chains;
+    for(const auto& chain : group)
+    {
+        chains.emplace_back(group.name());
+        chains.back().push_back(chain);
+    }
+    for(const auto& rep : replicas)
+    {
+        const auto& original = group.at(rep.front().first).name();
+        std::vector<std::size_t> shifts;
+        std::vector<std::string> comments;
+        for(const auto& r : rep)
+        {
+            shifts.push_back(r.second);
+            comments.push_back(" chain " + group.at(r.first).name() +
+                               ", the same as chain " + original);
+        }
+        detail::stamp_local_parameters(gen, out, chains.at(rep.front().first),
+                                       shifts, comments);
+    }
+
+    std::vector<std::reference_wrapper<const CGGroup<realT>>> refs(
+            chains.begin(), chains.end());
+    gen.generate(out, refs);
+    return out;
+}
+
+} // jarngreipr
+#endif// JARNGREIPR_FORCEFIELD_GENERATE_ASSEMBLY_HPP
@@ -0,0 +1,129 @@
+#ifndef JARNGREIPR_FORCEFIELD_INTER_CHAIN_CONTACTS_HPP
+#define JARNGREIPR_FORCEFIELD_INTER_CHAIN_CONTACTS_HPP
+#include <jarngreipr/forcefield/ParameterTable.hpp>
+#include <jarngreipr/geometry/CellList.hpp>
+#include <jarngreipr/geometry/distance.hpp>
+#include <jarngreipr/model/CGChain.hpp>
+#include <jarngreipr/util/thread_pool.hpp>
+#include <algorithm>
+#include <utility>
+#include <string>
+#include <vector>
+
+// utility functions mainly used by ForceFieldGenerators
+
+namespace jarngreipr
+{
+
+// a contact between the `first`-th bead of a chain and the `second`-th bead
+// of the chain `partner`.
+template<typename realT>
+struct InterChainContact
+{
+    std::size_t partner;
+    std::size_t first;
+    std::size_t second;
+    realT       coef;
+};
+
+// find contacts between beads in different chains.
+//
+// `chain_offsets` has (the number of chains + 1) elements, and the k-th bead
+// in the c-th chain has ID `chain_offsets[c] + k` in `cell_list`. Neighbors of
+// each bead are listed only once, and partners in the later chains that
+// satisfy `is_partner(c1, c2)` are checked by `contact(c1, k1, c2, k2)`.
+// It returns a pair of {whether they are in contact, coefficient}.
+//
+// The result has a list for each chain sorted by {partner, first, second},
+// that is the same order as nested loops over chains and beads. Chain pairs
+// that have no contact do not appear in it.
+template<typename realT, typename PartnerFunc, typename ContactFunc>
+std::vector<std::vector<InterChainContact<realT>>>
+find_inter_chain_contacts(ThreadPool& pool, const CellList<realT>& cell_list,
+                          const std::vector<std::size_t>& chain_offsets,
+                          PartnerFunc&& is_partner, ContactFunc&& contact)
+{
+    using contact_type = InterChainContact<realT>;
+    const std::size_t num_chains = chain_offsets.size() - 1;
+    const std::size_t num_beads  = chain_offsets.back();
+
+    // each bead is filled independently and merged in order.
+    std::vector<std::vector<contact_type>> found(num_beads);
+    pool.parallel_for(0, num_beads, [&](const std::size_t id1) -> void {
+        const std::size_t c1 = std::upper_bound(chain_offsets.begin(),
+            chain_offsets.end(), id1) - chain_offsets.begin() - 1;
+        const std::size_t k1 = id1 - chain_offsets[c1];
+
+        std::size_t c2 = c1;
+        // candidates are sorted, so chains are visited in ascending order
+        for(const auto id2 : cell_list.neighbors(id1))
+        {
+            if(id2 < chain_offsets[c1 + 1]) {continue;}
+            while(chain_offsets[c2 + 1] <= id2) {++c2;}
+            if(!is_partner(c1, c2)) {continue;}
+
+            const std::size_t k2 = id2 - chain_offsets[c2];
+            const auto found_contact = contact(c1, k1, c2, k2);
+            if(found_contact.first)
+            {
+                found[id1].push_back(contact_type{c2, k1, k2, found_contact.second});
+            }
+        }
+    });
+
+    std::vector<std::vector<contact_type>> retval(num_chains);
+    for(std::size_t c=0; c<num_chains; ++c)
+    {
+        auto& contacts = retval[c];
+        for(std::size_t id=chain_offsets[c]; id<chain_offsets[c+1]; ++id)
+        {
+            contacts.insert(contacts.end(), found[id].begin(), found[id].end());
+        }
+        std::stable_sort(contacts.begin(), contacts.end(),
+            [](const contact_type& lhs, const contact_type& rhs) noexcept {
+                return lhs.partner < rhs.partner;
+            });
+    }
+    return retval;
+}
+
+// contacts with the chain `partner` in the sorted list.
+template<typename realT>
+std::pair<typename std::vector<InterChainContact<realT>>::const_iterator,
+          typename std::vector<InterChainContact<realT>>::const_iterator>
+contacts_with(const std::vector<InterChainContact<realT>>& contacts,
+              const std::size_t partner)
+{
+    return std::equal_range(contacts.begin(), contacts.end(),
+        InterChainContact<realT>{partner, 0, 0, realT(0)},
+        [](const InterChainContact<realT>& lhs,
+           const InterChainContact<realT>& rhs) noexcept {
+            return lhs.partner < rhs.partner;
+        });
+}
+
+// append contacts in [first, last) between chain1 and chain2 as GoContact
+// parameters, `{indices = [i, j], v0 = native distance, k = coef}`.
+// `comment` is attached to the first parameter if there is any.
+template<typename realT, typename Iterator>
+void append_contacts(ParameterTable<realT>& params,
+                     const CGChain<realT>& chain1, const CGChain<realT>& chain2,
+                     Iterator first, const Iterator last, std::string comment)
+{
+    if(first == last) {return;}
+
+    const auto& beads1 = chain1.table();
+    const auto& beads2 = chain2.table();
+
+    params.add_comment(params.size(), std::move(comment));
+    for(; first != last; ++first)
+    {
+        params.push_back({beads1.index(first->first), beads2.index(first->second)},
+            {distance(beads1.position(first->first), beads2.position(first->second)),
+             first->coef});
+    }
+    return;
+}
+
+} // jarngreipr
+#endif//JARNGREIPR_FORCEFIELD_INTER_CHAIN_CONTACTS_HPP
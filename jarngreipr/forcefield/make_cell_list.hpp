@@ -0,0 +1,40 @@
+#ifndef JARNGREIPR_FORCEFIELD_MAKE_CELL_LIST_HPP
+#define JARNGREIPR_FORCEFIELD_MAKE_CELL_LIST_HPP
+#include <jarngreipr/geometry/CellList.hpp>
+#include <jarngreipr/model/CGChain.hpp>
+#include <functional>
+#include <vector>
+
+// utility function mainly used by ForceFieldGenerators
+
+namespace jarngreipr
+{
+
+// register heavy atoms of all the beads in the chains to a cell list.
+// The owner ID of an atom is the serial index of its bead through the chains,
+// i.e. the k-th bead in the 2nd chain has ID `chains[0].size() + k`.
+template<typename realT>
+CellList<realT> make_cell_list(
+    const std::vector<std::reference_wrapper<const CGChain<realT>>>& chains,
+    const realT cutoff)
+{
+    CellList<realT> cell_list(cutoff);
+
+    std::size_t owner = 0;
+    for(const auto& chain : chains)
+    {
+        for(const auto& bead : chain.get())
+        {
+            for(const auto& pos : bead->heavy_positions())
+            {
+                cell_list.add(owner, pos);
+            }
+            ++owner;
+        }
+    }
+    cell_list.make();
+    return cell_list;
+}
+
+} // jarngreipr
+#endif//JARNGREIPR_FORCEFIELD_MAKE_CELL_LIST_HPP
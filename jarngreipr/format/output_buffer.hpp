@@ -0,0 +1,118 @@
+#ifndef JARNGREIPR_OUTPUT_BUFFER_HPP
+#define JARNGREIPR_OUTPUT_BUFFER_HPP
+#include <jarngreipr/format/write_number.hpp>
+#include <type_traits>
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace jarngreipr
+{
+
+//
+// accumulates characters and writes them to a stream in large blocks.
+// Numbers are formatted directly into the buffer without allocation.
+//
+template<typename charT, typename traits>
+class output_buffer
+{
+    static_assert(std::is_same<charT, char>::value,
+                  "output_buffer supports only char streams");
+  public:
+
+    explicit output_buffer(std::basic_ostream<charT, traits>& os,
+                           const std::size_t capacity = 1 << 16)
+        : os_(os), size_(0), buffer_(capacity)
+    {}
+    ~output_buffer() {this->flush();}
+
+    output_buffer(const output_buffer&) = delete;
+    output_buffer& operator=(const output_buffer&) = delete;
+
+    output_buffer& put(const char c)
+    {
+        if(size_ == buffer_.size()) {this->flush();}
+        buffer_[size_++] = c;
+        return *this;
+    }
+    output_buffer& write(const char* s, const std::size_t n)
+    {
+        if(buffer_.size() < size_ + n)
+        {
+            this->flush();
+            if(buffer_.size() < n)
+            {
+                os_.write(s, n);
+                return *this;
+            }
+        }
+        std::copy(s, s + n, buffer_.data() + size_);
+        size_ += n;
+        return *this;
+    }
+    output_buffer& write(const std::string& s)
+    {
+        return this->write(s.data(), s.size());
+    }
+    template<std::size_t N>
+    output_buffer& write(const char (&s)[N])
+    {
+        return this->write(s, N - 1);
+    }
+
+    // the same as "%*.*f"
+    output_buffer& fixed(const double x, const int width, const int precision)
+    {
+        this->reserve(64);
+        const auto n = format_fixed(buffer_.data() + size_,
+                buffer_.size() - size_, x, width, precision);
+        if(size_ + n < buffer_.size())
+        {
+            size_ += n;
+            return *this;
+        }
+        // rarely happens, e.g. 1e300 with "%f"
+        std::vector<char> buf(n + 1);
+        format_fixed(buf.data(), buf.size(), x, width, precision);
+        return this->write(buf.data(), n);
+    }
+    // the same as "%*d"
+    output_buffer& integer(const std::int64_t x, const int width = 0)
+    {
+        this->reserve(static_cast<std::size_t>(std::max(width, 0)) + 24);
+        size_ += format_integer(buffer_.data() + size_,
+                buffer_.size() - size_, x, width);
+        return *this;
+    }
+
+    void flush()
+    {
+        if(size_ != 0)
+        {
+            os_.write(buffer_.data(), size_);
+            size_ = 0;
+        }
+        return;
+    }
+
+  private:
+
+    // make sure that the buffer has `n` more characters. The buffer grows if
+    // `n` is larger than the capacity.
+    void reserve(const std::size_t n)
+    {
+        if(buffer_.size() < size_ + n) {this->flush();}
+        if(buffer_.size() < n) {buffer_.resize(n);}
+        return;
+    }
+
+  private:
+
+    std::basic_ostream<charT, traits>& os_;
+    std::size_t       size_;
+    std::vector<char> buffer_;
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_OUTPUT_BUFFER_HPP
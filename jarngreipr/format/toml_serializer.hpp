@@ -20,47 +20,72 @@ struct inline_formatted_serializer
 
     inline_formatted_serializer(
         const std::string& fmt_int, const std::string& fmt_float)
-        : fmt_int_(fmt_int), fmt_float_(fmt_float)
-    {}
+        : fmt_int_(fmt_int), fmt_float_(fmt_float),
+          int_width_(-1), float_width_(-1), float_precision_(-1)
+    {
+        // "%d", "%5d", "%f", "%9.4f" are formatted without snprintf.
+        int precision = 0;
+        if(parse_format(fmt_int, 'd', int_width_, precision) && precision != -1)
+        {
+            int_width_ = -1;
+        }
+        if(parse_format(fmt_float, 'f', float_width_, float_precision_) &&
+           float_precision_ == -1)
+        {
+            float_precision_ = 6;
+        }
+    }
 
     std::string operator()(const toml::integer& x)
     {
-        return format_number(fmt_int_.data(), x);
+        char buf[64];
+        if(int_width_ < 0 || 32 < int_width_)
+        {
+            return format_number(fmt_int_.data(), x);
+        }
+        return std::string(buf, format_integer(buf, sizeof(buf), x, int_width_));
     }
     std::string operator()(const toml::floating& x)
     {
+        char buf[64];
+        if(float_width_ >= 0 && float_width_ <= 32)
+        {
+            const auto n = format_fixed(buf, sizeof(buf), x, float_width_,
+                                        float_precision_);
+            if(n < sizeof(buf)) {return std::string(buf, n);}
+        }
         return format_number(fmt_float_.data(), x);
     }
     std::string operator()(const array_type& x)
     {
         if(x.empty()) {return "[]";}
-        std::ostringstream oss;
-        oss << '[';
+        std::string str(1, '[');
         bool is_front = true;
         for(const auto& v: x)
         {
-            if(!is_front) {oss << ", ";}
-            oss << toml::visit(*this, v);
+            if(!is_front) {str += ", ";}
+            str += toml::visit(*this, v);
             is_front = false;
         }
-        oss << ']';
-        return oss.str();
+        str += ']';
+        return str;
     }
     std::string operator()(const table_type& x)
     {
-        std::ostringstream oss;
         if(x.empty()) {return "{}";}
 
-        oss << '{';
+        std::string str(1, '{');
         bool is_front = true;
         for(const auto& kv: x)
         {
-            if(!is_front) {oss << ", ";}
-            oss << kv.first << " = " << toml::visit(*this, kv.second);
+            if(!is_front) {str += ", ";}
+            str += kv.first;
+            str += " = ";
+            str += toml::visit(*this, kv.second);
             is_front = false;
         }
-        oss << '}';
-        return oss.str();
+        str += '}';
+        return str;
     }
     template<typename T, typename std::enable_if<
         !std::is_same<T, toml::floating>::value &&
@@ -75,10 +100,47 @@ struct inline_formatted_serializer
         return oss.str();
     }
 
+  private:
+
+    // parse "%[width][.precision]<conv>". precision is -1 if not given.
+    static bool parse_format(const std::string& fmt, const char conv,
+                             int& width, int& precision)
+    {
+        width = -1;
+        precision = -1;
+        if(fmt.size() < 2 || fmt.front() != '%' || fmt.back() != conv)
+        {
+            return false;
+        }
+        std::size_t i = 1;
+        int w = 0;
+        for(; i+1 < fmt.size() && '0' <= fmt[i] && fmt[i] <= '9'; ++i)
+        {
+            if(i == 1 && fmt[i] == '0') {return false;} // zero padding
+            w = w * 10 + (fmt[i] - '0');
+        }
+        int p = -1;
+        if(i+1 < fmt.size() && fmt[i] == '.')
+        {
+            p = 0;
+            for(++i; i+1 < fmt.size() && '0' <= fmt[i] && fmt[i] <= '9'; ++i)
+            {
+                p = p * 10 + (fmt[i] - '0');
+            }
+        }
+        if(i+1 != fmt.size()) {return false;}
+        width     = w;
+        precision = p;
+        return true;
+    }
+
   private:
 
     std::string fmt_int_;
     std::string fmt_float_;
+    int int_width_;
+    int float_width_;
+    int float_precision_;
 };
 
 } // jarngreipr
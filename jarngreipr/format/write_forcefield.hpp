@@ -2,22 +2,27 @@
 #define JARNGREIPR_WRITE_FORCEFIELD_HPP
 #include <jarngreipr/util/log.hpp>
 #include <jarngreipr/format/toml_serializer.hpp>
+#include <jarngreipr/format/output_buffer.hpp>
+#include <jarngreipr/forcefield/ForceField.hpp>
+#include <jarngreipr/util/output_file.hpp>
+#include <jarngreipr/util/parallel_for.hpp>
 #include <algorithm>
+#include <cassert>
 #include <ostream>
+#include <string>
+#include <vector>
 
 namespace jarngreipr
 {
 
-//
-// Without considering the readability, this function is not needed because
-// toml11 has a serializer. But to prettify the output, some sorting and
-// extra formatting stuff is needed.
-//
+namespace detail
+{
+// write the keys of a [[forcefields.local]] table except `parameters`.
 template<typename charT, typename traits, typename Comment,
          template<typename...> class Map, template<typename...> class Array>
 std::basic_ostream<charT, traits>&
-write_local_forcefield(std::basic_ostream<charT, traits>& os,
-                       const toml::basic_value<Comment, Map, Array>& ff)
+write_local_header(std::basic_ostream<charT, traits>& os,
+                   const toml::basic_value<Comment, Map, Array>& ff)
 {
     using value_type = toml::basic_value<Comment, Map, Array>;
 
@@ -52,6 +57,102 @@ write_local_forcefield(std::basic_ostream<charT, traits>& os,
         }
         os << "# }}}\n";
     }
+    return os;
+}
+
+// bare keys are written as they are, without making a new string.
+template<typename charT, typename traits>
+void write_key(output_buffer<charT, traits>& buf, const std::string& key)
+{
+    const bool is_bare = !key.empty() && std::all_of(key.begin(), key.end(),
+        [](const char c) {
+            return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') ||
+                   ('0' <= c && c <= '9') || c == '_' || c == '-';
+        });
+    if(is_bare)
+    {
+        buf.write(key);
+    }
+    else
+    {
+        buf.write(toml::format_key(key));
+    }
+    return;
+}
+
+// write a basic string with escapes, in the same way as toml::format.
+template<typename charT, typename traits>
+void write_string(output_buffer<charT, traits>& buf, const std::string& str)
+{
+    buf.put('"');
+    for(const char c : str)
+    {
+        switch(c)
+        {
+            case '\\': {buf.write("\\\\"); break;}
+            case '\"': {buf.write("\\\""); break;}
+            case '\b': {buf.write("\\b");  break;}
+            case '\t': {buf.write("\\t");  break;}
+            case '\f': {buf.write("\\f");  break;}
+            case '\n': {buf.write("\\n");  break;}
+            case '\r': {buf.write("\\r");  break;}
+            default:
+            {
+                const auto u = static_cast<unsigned char>(c);
+                if(u < 0x20 || u == 0x7F) // other control characters
+                {
+                    const char hex[] = "0123456789ABCDEF";
+                    buf.write("\\u00").put(hex[u / 16]).put(hex[u % 16]);
+                }
+                else
+                {
+                    buf.put(c);
+                }
+                break;
+            }
+        }
+    }
+    buf.put('"');
+    return;
+}
+
+// numbers are written in "%d" and "%9.4f", the same as inline_serializer.
+template<typename charT, typename traits, typename Value>
+void write_inline_value(output_buffer<charT, traits>& buf, const Value& v,
+                        inline_formatted_serializer<Value>& inline_serializer)
+{
+    assert(v.comments().empty());
+    if(v.is_floating())
+    {
+        buf.fixed(v.as_floating(), 9, 4);
+    }
+    else if(v.is_integer())
+    {
+        buf.integer(v.as_integer());
+    }
+    else
+    {
+        buf.write(toml::visit(inline_serializer, v));
+    }
+    return;
+}
+} // detail
+
+//
+// Without considering the readability, this function is not needed because
+// toml11 has a serializer. But to prettify the output, some sorting and
+// extra formatting stuff is needed.
+//
+template<typename charT, typename traits, typename Comment,
+         template<typename...> class Map, template<typename...> class Array>
+std::basic_ostream<charT, traits>&
+write_local_forcefield(std::basic_ostream<charT, traits>& os,
+                       const toml::basic_value<Comment, Map, Array>& ff)
+{
+    using value_type = toml::basic_value<Comment, Map, Array>;
+    detail::write_local_header(os, ff);
+
+    inline_formatted_serializer<value_type> inline_serializer("%d", "%9.4f");
 
     // ========================================================================
     // output `parameters` field in an array-of-inline-tables way.
@@ -59,62 +160,72 @@ write_local_forcefield(std::basic_ostream<charT, traits>& os,
     // ------------------------------------------------------------------------
     // find the maximum index and calculate the max width to write them
 
-    std::size_t max_index = 0;
-    for(const auto& p : toml::find(ff, "parameters").as_array())
+    // the indices are read in place, not converted into a vector.
+    const auto& params = toml::find(ff, "parameters").as_array();
+    toml::integer max_index = 0;
+    for(const auto& p : params)
     {
         if(p.as_table().count("indices") == 0)
         {
             log::error("`parameters` does not has `indices` field\n");
         }
-        const auto idxs = toml::find<std::vector<std::size_t>>(p, "indices");
-        max_index = std::max(max_index, *std::max_element(idxs.begin(), idxs.end()));
+        for(const auto& idx : p.as_table().at("indices").as_array())
+        {
+            max_index = std::max(max_index, idx.as_integer());
+        }
     }
-    const auto idx_width = std::to_string(max_index).size();
+    char width_buf[32];
+    const int idx_width = static_cast<int>(
+            format_integer(width_buf, sizeof(width_buf), max_index));
 
     // ------------------------------------------------------------------------
     // output parameters
 
-    os << "parameters = [ # {{{\n";
-    for(const auto& p : toml::find(ff, "parameters").as_array())
+    output_buffer<charT, traits> buf(os);
+    buf.write("parameters = [ # {{{\n");
+    for(const auto& p : params)
     {
         // write comment if exists
-        if(!p.comments().empty())
+        for(const auto& c : p.comments())
         {
-            os << p.comments();
+            buf.put('#').write(c).put('\n');
         }
 
         // write indices first
-        os << "{indices = [";
+        buf.write("{indices = [");
+        bool is_front = true;
+        for(const auto& idx : p.as_table().at("indices").as_array())
         {
-            const auto idxs = toml::find<std::vector<std::size_t>>(p, "indices");
-            for(auto iter = idxs.begin(); iter != idxs.end(); ++iter)
-            {
-                if(iter != idxs.begin()) {os << ',';}
-                os << std::setw(idx_width) << *iter;
-            }
+            if(!is_front) {buf.put(',');}
+            buf.integer(idx.as_integer(), idx_width);
+            is_front = false;
         }
-        os << ']';
+        buf.put(']');
 
         // write other keys in the fixed order
         for(const auto& kv : p.as_table())
         {
             if(kv.first == "indices") {continue;}
-            assert(kv.second.comments().empty());
-
-            os << ", " << toml::format_key(kv.first) << " = "
-               << toml::visit(inline_serializer, kv.second);
+            buf.write(", ");
+            detail::write_key(buf, kv.first);
+            buf.write(" = ");
+            detail::write_inline_value(buf, kv.second, inline_serializer);
         }
-        os << "},\n";
+        buf.write("},\n");
     }
-    os << "] # }}}\n";
+    buf.write("] # }}}\n");
+    buf.flush();
     return os;
 }
 
+namespace detail
+{
+// write the keys of a [[forcefields.global]] table except `parameters`.
 template<typename charT, typename traits, typename Comment,
          template<typename...> class Map, template<typename...> class Array>
 std::basic_ostream<charT, traits>&
-write_global_forcefield(std::basic_ostream<charT, traits>& os,
-                        const toml::basic_value<Comment, Map, Array>& ff)
+write_global_header(std::basic_ostream<charT, traits>& os,
+                    const toml::basic_value<Comment, Map, Array>& ff)
 {
     using value_type = toml::basic_value<Comment, Map, Array>;
     if(!ff.comments().empty())
@@ -195,6 +306,20 @@ write_global_forcefield(std::basic_ostream<charT, traits>& os,
         os << toml::format_key(key)
            << " = " << toml::visit(inline_serializer, kv.second) << '\n';
     }
+    return os;
+}
+} // detail
+
+template<typename charT, typename traits, typename Comment,
+         template<typename...> class Map, template<typename...> class Array>
+std::basic_ostream<charT, traits>&
+write_global_forcefield(std::basic_ostream<charT, traits>& os,
+                        const toml::basic_value<Comment, Map, Array>& ff)
+{
+    using value_type = toml::basic_value<Comment, Map, Array>;
+    detail::write_global_header(os, ff);
+
+    inline_formatted_serializer<value_type> inline_serializer("%d", "%9.4f");
 
     // ========================================================================
     // output parameters = [{...}, ...]
@@ -202,37 +327,262 @@ write_global_forcefield(std::basic_ostream<charT, traits>& os,
     // ------------------------------------------------------------------------
     // find the maximum index and calculate the max width to write them
 
-    std::size_t max_index = 0;
-    for(const auto& p : toml::find(ff, "parameters").as_array())
+    const auto& params = toml::find(ff, "parameters").as_array();
+    toml::integer max_index = 0;
+    for(const auto& p : params)
     {
         if(p.as_table().count("index") == 0)
         {
             log::error("`parameters` does not has `index` field");
         }
-        max_index = std::max(max_index, toml::find<std::size_t>(p, "index"));
+        max_index = std::max(max_index, p.as_table().at("index").as_integer());
     }
-    const auto idx_width = std::to_string(max_index).size();
+    char width_buf[32];
+    const int idx_width = static_cast<int>(
+            format_integer(width_buf, sizeof(width_buf), max_index));
 
     // ------------------------------------------------------------------------
     // output parameters
 
-    os << "parameters = [ # {{{\n";
-    for(const auto& p : toml::find(ff, "parameters").as_array())
+    output_buffer<charT, traits> buf(os);
+    buf.write("parameters = [ # {{{\n");
+    for(const auto& p : params)
     {
-        os << "{index = "
-           << std::setw(idx_width) << toml::find<std::size_t>(p, "index");
-
+        buf.write("{index = ").integer(p.as_table().at("index").as_integer(), idx_width);
         for(const auto& kv : p.as_table())
         {
             if(kv.first == "index") {continue;}
-            assert(kv.second.comments().empty());
+            buf.write(", ");
+            detail::write_key(buf, kv.first);
+            buf.write(" = ");
+            detail::write_inline_value(buf, kv.second, inline_serializer);
+        }
+        buf.write("},\n");
+    }
+    buf.write("] # }}}\n");
+    buf.flush();
+    return os;
+}
+
+// ============================================================================
+// writers for ForceField. The layout is the same as the above.
+
+namespace detail
+{
+// a key of parameters with the strings written before and after the value.
+// `prefix` may open an inline table and `suffix` may close it.
+struct parameter_field
+{
+    bool        is_real;
+    std::size_t column;
+    std::string prefix;
+    std::string suffix;
+};
+
+// keys are sorted in the same way as toml::table, e.g. "FlexibleLocalDihedral.k"
+// comes before "Gaussian.k", and "Gaussian.k" before "k".
+template<typename realT>
+std::vector<parameter_field>
+make_parameter_fields(const ParameterTable<realT>& params)
+{
+    using path_type = std::vector<std::string>;
+    const auto split = [](const std::string& key) -> path_type {
+        const auto dot = key.find('.');
+        if(dot == std::string::npos) {return path_type{key};}
+        return path_type{key.substr(0, dot), key.substr(dot+1)};
+    };
+
+    std::vector<std::pair<path_type, std::pair<bool, std::size_t>>> keys;
+    for(std::size_t i=0; i<params.real_keys().size(); ++i)
+    {
+        keys.emplace_back(split(params.real_keys().at(i)), std::make_pair(true, i));
+    }
+    for(std::size_t i=0; i<params.string_keys().size(); ++i)
+    {
+        keys.emplace_back(split(params.string_keys().at(i)), std::make_pair(false, i));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    const auto in_same_table = [&](const std::size_t i, const std::size_t j) {
+        return keys.at(i).first.size() == 2 && keys.at(j).first.size() == 2 &&
+               keys.at(i).first.front() == keys.at(j).first.front();
+    };
+
+    std::vector<parameter_field> fields;
+    for(std::size_t i=0; i<keys.size(); ++i)
+    {
+        const auto& path = keys.at(i).first;
+        parameter_field field{keys.at(i).second.first, keys.at(i).second.second,
+                              ", ", ""};
+        if(path.size() == 1)
+        {
+            field.prefix += toml::format_key(path.front()) + " = ";
+        }
+        else
+        {
+            if(i == 0 || !in_same_table(i-1, i))
+            {
+                field.prefix += toml::format_key(path.front()) + " = {";
+            }
+            field.prefix += path.back() + " = ";
+            if(i+1 == keys.size() || !in_same_table(i, i+1))
+            {
+                field.suffix = "}";
+            }
+        }
+        fields.push_back(std::move(field));
+    }
+    return fields;
+}
 
-            os << ", " << toml::format_key(kv.first) << " = "
-               << toml::visit(inline_serializer, kv.second);
+template<typename charT, typename traits, typename realT>
+void write_parameter_fields(output_buffer<charT, traits>& buf,
+        const ParameterTable<realT>& params, const std::size_t i,
+        const std::vector<parameter_field>& fields)
+{
+    for(const auto& field : fields)
+    {
+        buf.write(field.prefix);
+        if(field.is_real)
+        {
+            buf.fixed(params.real(i, field.column), 9, 4); // "%9.4f"
+        }
+        else
+        {
+            write_string(buf, params.string(i, field.column));
+        }
+        buf.write(field.suffix);
+    }
+    return;
+}
+
+// ParameterTable knows the largest index, so the parameters are not scanned.
+template<typename realT>
+int index_width(const ParameterTable<realT>& params)
+{
+    char buf[32];
+    return static_cast<int>(format_integer(buf, sizeof(buf),
+                static_cast<std::int64_t>(params.max_index())));
+}
+} // detail
+
+template<typename charT, typename traits, typename realT>
+std::basic_ostream<charT, traits>&
+write_local_forcefield(std::basic_ostream<charT, traits>& os,
+                       const ForceFieldTable<realT>& ff)
+{
+    detail::write_local_header(os, ff.header);
+
+    const auto& params    = ff.parameters;
+    const auto  fields    = detail::make_parameter_fields(params);
+    const auto  idx_width = detail::index_width(params);
+
+    output_buffer<charT, traits> buf(os);
+    auto comment = params.comments().begin();
+    buf.write("parameters = [ # {{{\n");
+    for(std::size_t i=0; i<params.size(); ++i)
+    {
+        for(; comment != params.comments().end() && comment->first == i; ++comment)
+        {
+            buf.put('#').write(comment->second).put('\n');
         }
-        os << "},\n";
+        buf.write("{indices = [");
+        for(std::size_t k=0; k<params.arity(); ++k)
+        {
+            if(k != 0) {buf.put(',');}
+            buf.integer(params.index(i, k), idx_width);
+        }
+        buf.put(']');
+        detail::write_parameter_fields(buf, params, i, fields);
+        buf.write("},\n");
+    }
+    buf.write("] # }}}\n");
+    buf.flush();
+    return os;
+}
+
+template<typename charT, typename traits, typename realT>
+std::basic_ostream<charT, traits>&
+write_global_forcefield(std::basic_ostream<charT, traits>& os,
+                        const ForceFieldTable<realT>& ff)
+{
+    detail::write_global_header(os, ff.header);
+
+    const auto& params    = ff.parameters;
+    const auto  fields    = detail::make_parameter_fields(params);
+    const auto  idx_width = detail::index_width(params);
+
+    output_buffer<charT, traits> buf(os);
+    buf.write("parameters = [ # {{{\n");
+    for(std::size_t i=0; i<params.size(); ++i)
+    {
+        buf.write("{index = ").integer(params.index(i, 0), idx_width);
+        detail::write_parameter_fields(buf, params, i, fields);
+        buf.write("},\n");
+    }
+    buf.write("] # }}}\n");
+    buf.flush();
+    return os;
+}
+
+template<typename charT, typename traits, typename realT>
+std::basic_ostream<charT, traits>&
+write_forcefield(std::basic_ostream<charT, traits>& os, const ForceField<realT>& ff)
+{
+    os << "[[forcefields]]\n";
+    for(const auto& local : ff.local())
+    {
+        write_local_forcefield(os, local);
+    }
+    for(const auto& global : ff.global())
+    {
+        write_global_forcefield(os, global);
+    }
+    return os;
+}
+
+// write each [[forcefields.local]] and [[forcefields.global]] table to its
+// own file, `{prefix}_local_{i}.toml` or `{prefix}_global_{i}.toml` in `path`,
+// using `num_threads` threads. `os` gets a [[forcefields]] table that refers
+// to the files, so the files should be found under `files.input.path`.
+template<typename charT, typename traits, typename realT>
+std::basic_ostream<charT, traits>&
+write_forcefield_files(std::basic_ostream<charT, traits>& os,
+        const ForceField<realT>& ff, const std::string& path,
+        const std::string& prefix, const std::size_t num_threads)
+{
+    const std::size_t num_local = ff.local().size();
+    std::vector<std::string> fnames;
+    for(std::size_t i=0; i<ff.local().size(); ++i)
+    {
+        fnames.push_back(prefix + "_local_" + std::to_string(i) + ".toml");
+    }
+    for(std::size_t i=0; i<ff.global().size(); ++i)
+    {
+        fnames.push_back(prefix + "_global_" + std::to_string(i) + ".toml");
+    }
+
+    // a large table, e.g. contacts, occupies one thread while the others
+    // write the rest.
+    parallel_for(num_threads, 0, fnames.size(), [&](const std::size_t i) {
+        output_file ofs(path + fnames.at(i));
+        if(i < num_local)
+        {
+            write_local_forcefield(ofs, ff.local().at(i));
+        }
+        else
+        {
+            write_global_forcefield(ofs, ff.global().at(i - num_local));
+        }
+    });
+
+    os << "[[forcefields]]\n";
+    for(std::size_t i=0; i<fnames.size(); ++i)
+    {
+        os << ((i < num_local) ? "[[forcefields.local]]\n" :
+                                 "[[forcefields.global]]\n");
+        os << "file_name = " << toml::value(fnames.at(i)) << '\n';
     }
-    os << "] # }}}\n";
     return os;
 }
 
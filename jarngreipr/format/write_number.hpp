@@ -3,7 +3,9 @@
 #include <vector>
 #include <string>
 #include <ostream>
+#include <cstdint>
 #include <cstdio>
+#include <cmath>
 
 namespace jarngreipr
 {
@@ -11,10 +13,17 @@ namespace jarngreipr
 template<typename ... Ts>
 std::string format_number(const char* fmt, const Ts& ... xs)
 {
-    const std::size_t N = std::snprintf(nullptr, 0, fmt, xs ...);
+    // most of the numbers fit in a small buffer.
+    char small[64];
+    const int N = std::snprintf(small, sizeof(small), fmt, xs ...);
+    if(N < 0) {return std::string();}
+    if(static_cast<std::size_t>(N) < sizeof(small))
+    {
+        return std::string(small, N);
+    }
     std::vector<char> buf(N + 1);
     std::snprintf(buf.data(), buf.size(), fmt, xs...);
-    return std::string(buf.data());
+    return std::string(buf.data(), N);
 }
 
 template<typename ... Ts>
@@ -24,5 +33,110 @@ std::ostream& write_number(std::ostream& os, const char* fmt, const Ts& ... xs)
     return os;
 }
 
+// ----------------------------------------------------------------------------
+// The following functions behave in the same way as
+// `std::snprintf(buf, size, "%*.*f", width, precision, x)` and
+// `std::snprintf(buf, size, "%*lld", width, x)`, but do not parse the format.
+// They return the length of the result, and write it if it fits in `size`.
+
+namespace detail
+{
+// write digits of x from the end of the buffer. returns the first digit.
+inline char* write_digits_backward(char* last, std::uint64_t x, int min_digits)
+{
+    while(x != 0 || min_digits > 0)
+    {
+        *--last = static_cast<char>('0' + x % 10);
+        x /= 10;
+        --min_digits;
+    }
+    return last;
+}
+
+// copy [first, last) into buf with padding, in the way of snprintf.
+inline std::size_t pad_and_copy(char* buf, const std::size_t size,
+        const char* first, const char* last, const int width)
+{
+    const std::size_t len = last - first;
+    const std::size_t pad = (width > 0 && static_cast<std::size_t>(width) > len) ?
+                            static_cast<std::size_t>(width) - len : 0;
+    if(pad + len < size)
+    {
+        for(std::size_t i=0; i<pad; ++i) {buf[i] = ' ';}
+        for(std::size_t i=0; i<len; ++i) {buf[pad + i] = first[i];}
+        buf[pad + len] = '\0';
+    }
+    else if(size != 0)
+    {
+        std::snprintf(buf, size, "%*.*s", width, static_cast<int>(len), first);
+    }
+    return pad + len;
+}
+} // detail
+
+inline std::size_t format_fixed(char* buf, const std::size_t size, const double x,
+                                const int width, const int precision)
+{
+    constexpr double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    const auto fallback = [&]() -> std::size_t {
+        return std::snprintf(buf, size, "%*.*f", width, precision, x);
+    };
+    if(precision < 0 || 9 < precision) {return fallback();}
+
+    // x * 10^precision is an integer + fraction. Since |x| is small enough, the
+    // integer part is exact and the fraction has an error less than 1 ulp.
+    // If the fraction is too close to 0.5, it cannot tell the rounded value,
+    // so snprintf is used. The same for NaN, inf and huge values.
+    const double scaled = std::abs(x) * pow10[precision];
+    if(!(scaled < 4503599627370496.0)) {return fallback();} // 2^52
+    const double integral = std::floor(scaled);
+    const double fraction = scaled - integral;
+    if(std::abs(fraction - 0.5) <= scaled * 2.3e-16 + 1e-300)
+    {
+        return fallback();
+    }
+    const auto rounded = static_cast<std::uint64_t>(integral) +
+                         ((fraction > 0.5) ? 1u : 0u);
+
+    const auto base = static_cast<std::uint64_t>(pow10[precision]);
+    char  digits[40];
+    char* last  = digits + sizeof(digits);
+    char* first = last;
+    if(precision != 0)
+    {
+        first = detail::write_digits_backward(first, rounded % base, precision);
+        *--first = '.';
+    }
+    first = detail::write_digits_backward(first, rounded / base, 1);
+    if(std::signbit(x)) {*--first = '-';}
+
+    return detail::pad_and_copy(buf, size, first, last, width);
+}
+
+inline std::size_t format_integer(char* buf, const std::size_t size,
+                                  const std::int64_t x, const int width = 0)
+{
+    const std::uint64_t abs_x = (x < 0) ? 0u - static_cast<std::uint64_t>(x) :
+                                          static_cast<std::uint64_t>(x);
+    char  digits[24];
+    char* last  = digits + sizeof(digits);
+    char* first = detail::write_digits_backward(last, abs_x, 1);
+    if(x < 0) {*--first = '-';}
+    return detail::pad_and_copy(buf, size, first, last, width);
+}
+
+// the same as `write_number(os, "%*.*f", width, precision, x)`.
+inline std::ostream& write_fixed(std::ostream& os, const double x,
+                                 const int width, const int precision)
+{
+    char buf[64];
+    const auto n = format_fixed(buf, sizeof(buf), x, width, precision);
+    if(n < sizeof(buf))
+    {
+        return os.write(buf, n);
+    }
+    return write_number(os, "%*.*f", width, precision, x);
+}
+
 }
 #endif// JARNGREIPR_WRITE_NUMBER_HPP
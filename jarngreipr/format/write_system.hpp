@@ -56,8 +56,12 @@ write_system(std::basic_ostream<charT, traits>& os,
         {
             os << particle.comments();
         }
-        os << "{m = "     << format_number("%8.3f", m);
-        os << ", pos = "  << format_number("[%9.4f,%9.4f,%9.4f]", p[0], p[1], p[2]);
+        os << "{m = ";
+        write_fixed(os, m, 8, 3);
+        os << ", pos = [";
+        write_fixed(os, p[0], 9, 4) << ',';
+        write_fixed(os, p[1], 9, 4) << ',';
+        write_fixed(os, p[2], 9, 4) << ']';
         os << ", name = " << n << ", group = " << g << "},\n";
     }
     os << "] # }}}\n";
@@ -0,0 +1,197 @@
+#ifndef JARNGREIPR_GEOMETRY_CELL_LIST_HPP
+#define JARNGREIPR_GEOMETRY_CELL_LIST_HPP
+#include <jarngreipr/util/log.hpp>
+#include <mjolnir/math/math.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <limits>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace jarngreipr
+{
+
+//
+// A uniform grid that finds pairs of owners (e.g. CG beads) that might have
+// points (e.g. atoms) within the cutoff distance.
+//
+// Each point belongs to an owner. After all the points are registered and
+// `make()` is called, `neighbors(i)` returns owners that have at least one
+// point in the cells adjacent to the cells occupied by the points of `i`.
+// It is a superset of the owners that are actually within the cutoff, so
+// the caller should check the distance exactly.
+//
+template<typename realT>
+class CellList
+{
+  public:
+    using real_type       = realT;
+    using coordinate_type = mjolnir::math::Vector<real_type, 3>;
+    using cell_index_type = std::array<std::size_t, 3>;
+
+  public:
+
+    explicit CellList(const real_type cutoff)
+        // make a cell slightly wider than the cutoff so that the rounding
+        // error in the cell index never drops a pair on the boundary.
+        : width_(cutoff * (1.0 + 1e-6)), dims_{{0, 0, 0}}
+    {
+        if(!(cutoff > 0.0))
+        {
+            log::error("CellList: cutoff length should be positive: ",
+                       cutoff, '\n');
+            std::terminate();
+        }
+    }
+    ~CellList() = default;
+    CellList(const CellList&) = default;
+    CellList(CellList&&)      = default;
+    CellList& operator=(const CellList&) = default;
+    CellList& operator=(CellList&&)      = default;
+
+    void add(const std::size_t owner, const coordinate_type& pos)
+    {
+        this->owners_   .push_back(owner);
+        this->positions_.push_back(pos);
+    }
+
+    void make()
+    {
+        this->points_.clear();
+        this->cell_owners_.clear();
+        this->cell_offsets_.assign(1, 0);
+        if(this->positions_.empty()) {return;}
+
+        this->lower_ = this->positions_.front();
+        coordinate_type upper = this->positions_.front();
+        for(const auto& pos : this->positions_)
+        {
+            for(std::size_t i=0; i<3; ++i)
+            {
+                this->lower_[i] = std::min(this->lower_[i], pos[i]);
+                upper[i]        = std::max(upper[i],        pos[i]);
+            }
+        }
+        for(std::size_t i=0; i<3; ++i)
+        {
+            this->dims_[i] = static_cast<std::size_t>(
+                std::floor((upper[i] - this->lower_[i]) / this->width_)) + 1;
+        }
+
+        // {owner, cell} and {cell, owner}, sorted and uniqued.
+        std::vector<std::pair<std::size_t, std::size_t>> cell_owner;
+        this->points_.reserve(this->positions_.size());
+        cell_owner   .reserve(this->positions_.size());
+        for(std::size_t i=0; i<this->positions_.size(); ++i)
+        {
+            const auto cell = this->cell_of(this->positions_[i]);
+            this->points_.emplace_back(this->owners_[i], cell);
+            cell_owner   .emplace_back(cell, this->owners_[i]);
+        }
+        std::sort(this->points_.begin(), this->points_.end());
+        this->points_.erase(std::unique(this->points_.begin(),
+                            this->points_.end()), this->points_.end());
+        std::sort(cell_owner.begin(), cell_owner.end());
+        cell_owner.erase(std::unique(cell_owner.begin(), cell_owner.end()),
+                         cell_owner.end());
+
+        // owners in the cell `c` are in [cell_offsets_[c], cell_offsets_[c+1])
+        this->cell_offsets_.assign(dims_[0] * dims_[1] * dims_[2] + 1, 0);
+        this->cell_owners_.reserve(cell_owner.size());
+        for(const auto& co : cell_owner)
+        {
+            this->cell_offsets_[co.first + 1] += 1;
+            this->cell_owners_.push_back(co.second);
+        }
+        for(std::size_t i=1; i<this->cell_offsets_.size(); ++i)
+        {
+            this->cell_offsets_[i] += this->cell_offsets_[i-1];
+        }
+        return;
+    }
+
+    // owners that might be within the cutoff, in ascending order.
+    // the owner itself is also contained if it has any point.
+    std::vector<std::size_t> neighbors(const std::size_t owner) const
+    {
+        const auto first = std::lower_bound(points_.begin(), points_.end(),
+            std::make_pair(owner, std::size_t(0)));
+        const auto last  = std::lower_bound(points_.begin(), points_.end(),
+            std::make_pair(owner + 1, std::size_t(0)));
+
+        std::vector<std::size_t> cells;
+        for(auto iter = first; iter != last; ++iter)
+        {
+            const auto idx = this->index_of(iter->second);
+            for(std::size_t z = (idx[2] == 0 ? 0 : idx[2]-1),
+                ze = std::min(idx[2]+2, dims_[2]); z < ze; ++z)
+            {
+            for(std::size_t y = (idx[1] == 0 ? 0 : idx[1]-1),
+                ye = std::min(idx[1]+2, dims_[1]); y < ye; ++y)
+            {
+            for(std::size_t x = (idx[0] == 0 ? 0 : idx[0]-1),
+                xe = std::min(idx[0]+2, dims_[0]); x < xe; ++x)
+            {
+                cells.push_back(x + dims_[0] * (y + dims_[1] * z));
+            }
+            }
+            }
+        }
+        std::sort(cells.begin(), cells.end());
+        cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+        std::vector<std::size_t> retval;
+        for(const auto cell : cells)
+        {
+            retval.insert(retval.end(),
+                          cell_owners_.begin() + cell_offsets_[cell],
+                          cell_owners_.begin() + cell_offsets_[cell + 1]);
+        }
+        std::sort(retval.begin(), retval.end());
+        retval.erase(std::unique(retval.begin(), retval.end()), retval.end());
+        return retval;
+    }
+
+    real_type width() const noexcept {return width_;}
+
+  private:
+
+    std::size_t cell_of(const coordinate_type& pos) const noexcept
+    {
+        cell_index_type idx;
+        for(std::size_t i=0; i<3; ++i)
+        {
+            idx[i] = std::min(dims_[i] - 1, static_cast<std::size_t>(
+                std::floor((pos[i] - lower_[i]) / width_)));
+        }
+        return idx[0] + dims_[0] * (idx[1] + dims_[1] * idx[2]);
+    }
+    cell_index_type index_of(const std::size_t cell) const noexcept
+    {
+        return cell_index_type{{cell % dims_[0],
+                                (cell / dims_[0]) % dims_[1],
+                                 cell / (dims_[0] * dims_[1])}};
+    }
+
+  private:
+
+    real_type       width_;
+    coordinate_type lower_;
+    cell_index_type dims_;
+
+    // registered points
+    std::vector<std::size_t>     owners_;
+    std::vector<coordinate_type> positions_;
+
+    // {owner, cell} pairs sorted by owner
+    std::vector<std::pair<std::size_t, std::size_t>> points_;
+
+    // owners in each cell, concatenated in the order of cell index
+    std::vector<std::size_t> cell_offsets_;
+    std::vector<std::size_t> cell_owners_;
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_GEOMETRY_CELL_LIST_HPP
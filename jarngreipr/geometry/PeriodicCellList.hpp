@@ -0,0 +1,186 @@
+#ifndef JARNGREIPR_GEOMETRY_PERIODIC_CELL_LIST_HPP
+#define JARNGREIPR_GEOMETRY_PERIODIC_CELL_LIST_HPP
+#include <jarngreipr/util/log.hpp>
+#include <mjolnir/math/math.hpp>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace jarngreipr
+{
+
+//
+// A uniform grid in a periodic box to check whether a point is close to any
+// of the points already inserted. Unlike CellList, points can be added one by
+// one, so it is suitable to place molecules randomly and reject overlaps.
+//
+// Each cell is at least as wide as the cutoff, so only the adjacent cells
+// need to be searched. Distances are calculated in the minimum image
+// convention. If the number of points is known, cells are made wider so that
+// a large and sparse box does not have more cells than points.
+//
+template<typename realT>
+class PeriodicCellList
+{
+  public:
+    using real_type       = realT;
+    using coordinate_type = mjolnir::math::Vector<real_type, 3>;
+
+  public:
+
+    PeriodicCellList(const coordinate_type& lower, const coordinate_type& upper,
+                     const real_type cutoff, const std::size_t expected_size = 0)
+        : cutoff_(cutoff), cutoff_sq_(cutoff * cutoff), lower_(lower)
+    {
+        if(!(cutoff > 0.0))
+        {
+            log::error("PeriodicCellList: cutoff length should be positive: ",
+                       cutoff, '\n');
+            std::terminate();
+        }
+        for(std::size_t i=0; i<3; ++i)
+        {
+            this->length_[i] = upper[i] - lower[i];
+            if(!(this->length_[i] > 0.0))
+            {
+                log::error("PeriodicCellList: upper should be larger than "
+                           "lower: ", lower[i], " >= ", upper[i], '\n');
+                std::terminate();
+            }
+        }
+        real_type min_width = cutoff;
+        if(expected_size != 0)
+        {
+            min_width = std::max(min_width, std::cbrt(
+                length_[0] * length_[1] * length_[2] / expected_size));
+        }
+        for(std::size_t i=0; i<3; ++i)
+        {
+            this->dims_[i]  = std::max<std::size_t>(1,
+                    static_cast<std::size_t>(std::floor(length_[i] / min_width)));
+            this->width_[i] = length_[i] / dims_[i];
+        }
+        this->head_.assign(dims_[0] * dims_[1] * dims_[2], npos);
+    }
+
+    std::size_t size() const noexcept {return positions_.size();}
+
+    void insert(const coordinate_type& pos)
+    {
+        const auto wrapped = this->wrap(pos);
+        const auto cell    = this->cell_of(this->index_of(wrapped));
+        this->positions_.push_back(wrapped);
+        this->next_     .push_back(this->head_[cell]);
+        this->head_[cell] = this->positions_.size() - 1;
+    }
+
+    // whether there is a point closer than the cutoff.
+    bool any_within(const coordinate_type& pos) const
+    {
+        const auto wrapped = this->wrap(pos);
+
+        // search only the cells that overlap with [pos - cutoff, pos + cutoff].
+        // Since a cell is not narrower than the cutoff, they are at most 3
+        // (or 4 if a boundary is hit by rounding).
+        std::array<std::array<std::size_t, 4>, 3> neighbors; // [dim][k]
+        std::array<std::size_t, 3> num_neighbors;
+        for(std::size_t i=0; i<3; ++i)
+        {
+            const auto first = static_cast<std::ptrdiff_t>(std::floor(
+                    (wrapped[i] - cutoff_ - lower_[i]) / width_[i]));
+            const auto last  = static_cast<std::ptrdiff_t>(std::floor(
+                    (wrapped[i] + cutoff_ - lower_[i]) / width_[i]));
+            const auto dim   = static_cast<std::ptrdiff_t>(dims_[i]);
+
+            // if a box has only 1 or 2 cells, do not search the same cell twice
+            num_neighbors[i] = std::min<std::size_t>(last - first + 1, dims_[i]);
+            for(std::size_t k=0; k<num_neighbors[i]; ++k)
+            {
+                neighbors[i][k] = ((first + static_cast<std::ptrdiff_t>(k)) % dim
+                                   + dim) % dim;
+            }
+        }
+        for(std::size_t z=0; z<num_neighbors[2]; ++z)
+        {
+        for(std::size_t y=0; y<num_neighbors[1]; ++y)
+        {
+        for(std::size_t x=0; x<num_neighbors[0]; ++x)
+        {
+            const auto cell = this->cell_of({{neighbors[0][x], neighbors[1][y],
+                                              neighbors[2][z]}});
+            for(std::size_t j=head_[cell]; j != npos; j = next_[j])
+            {
+                if(this->distance_sq(wrapped, positions_[j]) < cutoff_sq_)
+                {
+                    return true;
+                }
+            }
+        }
+        }
+        }
+        return false;
+    }
+
+  private:
+
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    coordinate_type wrap(coordinate_type pos) const noexcept
+    {
+        for(std::size_t i=0; i<3; ++i)
+        {
+            pos[i] -= length_[i] * std::floor((pos[i] - lower_[i]) / length_[i]);
+        }
+        return pos;
+    }
+    std::array<std::size_t, 3> index_of(const coordinate_type& wrapped) const noexcept
+    {
+        std::array<std::size_t, 3> idx;
+        for(std::size_t i=0; i<3; ++i)
+        {
+            // a wrapped point can be slightly out of the box by rounding.
+            const real_type f = std::floor((wrapped[i] - lower_[i]) / width_[i]);
+            idx[i] = (f < 0.0) ? 0 : std::min(dims_[i] - 1, static_cast<std::size_t>(f));
+        }
+        return idx;
+    }
+    std::size_t cell_of(const std::array<std::size_t, 3>& idx) const noexcept
+    {
+        return idx[0] + dims_[0] * (idx[1] + dims_[1] * idx[2]);
+    }
+    real_type distance_sq(const coordinate_type& lhs,
+                          const coordinate_type& rhs) const noexcept
+    {
+        real_type dist_sq = 0;
+        for(std::size_t i=0; i<3; ++i)
+        {
+            real_type d = lhs[i] - rhs[i];
+            d -= length_[i] * std::round(d / length_[i]);
+            dist_sq += d * d;
+        }
+        return dist_sq;
+    }
+
+  private:
+
+    real_type                  cutoff_;
+    real_type                  cutoff_sq_;
+    coordinate_type            lower_;
+    std::array<real_type, 3>   length_;
+    std::array<real_type, 3>   width_;
+    std::array<std::size_t, 3> dims_;
+
+    // points in a cell form a linked list: head_[cell] -> next_[i] -> ...
+    std::vector<coordinate_type> positions_;
+    std::vector<std::size_t>     next_;
+    std::vector<std::size_t>     head_;
+};
+
+template<typename realT>
+constexpr std::size_t PeriodicCellList<realT>::npos;
+
+} // jarngreipr
+#endif// JARNGREIPR_GEOMETRY_PERIODIC_CELL_LIST_HPP
@@ -0,0 +1,52 @@
+#ifndef JARNGREIPR_GEOMETRY_SYMMETRY_OPERATOR_HPP
+#define JARNGREIPR_GEOMETRY_SYMMETRY_OPERATOR_HPP
+#include <mjolnir/math/math.hpp>
+#include <array>
+
+namespace jarngreipr
+{
+
+// a rotation followed by a translation, x' = R x + t. It is used to make a
+// copy of an asymmetric unit, e.g. BIOMT records in a pdb file.
+template<typename realT>
+struct SymmetryOperator
+{
+    using real_type       = realT;
+    using coordinate_type = mjolnir::math::Vector<real_type, 3>;
+
+    std::array<std::array<real_type, 3>, 3> rotation;    // row-major
+    std::array<real_type, 3>                translation;
+
+    coordinate_type apply(const coordinate_type& x) const noexcept
+    {
+        coordinate_type retval;
+        for(std::size_t i=0; i<3; ++i)
+        {
+            retval[i] = rotation[i][0] * x[0] + rotation[i][1] * x[1] +
+                        rotation[i][2] * x[2] + translation[i];
+        }
+        return retval;
+    }
+
+    bool is_identity() const noexcept
+    {
+        for(std::size_t i=0; i<3; ++i)
+        {
+            for(std::size_t j=0; j<3; ++j)
+            {
+                if(rotation[i][j] != (i == j ? 1.0 : 0.0)) {return false;}
+            }
+            if(translation[i] != 0.0) {return false;}
+        }
+        return true;
+    }
+
+    static SymmetryOperator identity() noexcept
+    {
+        return SymmetryOperator{{{{{1.0, 0.0, 0.0}}, {{0.0, 1.0, 0.0}},
+                                  {{0.0, 0.0, 1.0}}}}, {{0.0, 0.0, 0.0}}};
+    }
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_GEOMETRY_SYMMETRY_OPERATOR_HPP
@@ -0,0 +1,136 @@
+#ifndef JARNGREIPR_GEOMETRY_MIN_DISTANCE
+#define JARNGREIPR_GEOMETRY_MIN_DISTANCE
+#include <jarngreipr/geometry/distance.hpp>
+#include <algorithm>
+#include <vector>
+#include <limits>
+
+#if !defined(JARNGREIPR_WITHOUT_SIMD) && (defined(__AVX__) || defined(__SSE2__))
+#include <immintrin.h>
+#endif
+
+namespace jarngreipr
+{
+
+// the minimum squared distance between two sets of points.
+// If one of them is empty, it returns the maximum value of realT.
+template<typename realT>
+realT min_distance_sq(const std::vector<mjolnir::math::Vector<realT, 3>>& lhs,
+                      const std::vector<mjolnir::math::Vector<realT, 3>>& rhs)
+{
+    realT min_dist_sq = std::numeric_limits<realT>::max();
+    for(const auto& p1 : lhs)
+    {
+        for(const auto& p2 : rhs)
+        {
+            min_dist_sq = std::min(distance_sq(p1, p2), min_dist_sq);
+        }
+    }
+    return min_dist_sq;
+}
+
+namespace detail
+{
+template<typename realT>
+bool any_pair_within_scalar(
+    const mjolnir::math::Vector<realT, 3>* lhs, const std::size_t lsize,
+    const mjolnir::math::Vector<realT, 3>* rhs, const std::size_t rsize,
+    const realT threshold_sq)
+{
+    for(std::size_t i=0; i<lsize; ++i)
+    {
+        for(std::size_t j=0; j<rsize; ++j)
+        {
+            if(distance_sq(lhs[i], rhs[j]) < threshold_sq) {return true;}
+        }
+    }
+    return false;
+}
+} // detail
+
+// It is equivalent to `min_distance_sq(lhs, rhs) < threshold_sq`, but stops
+// as soon as a pair closer than the threshold is found.
+template<typename realT>
+bool any_pair_within(const std::vector<mjolnir::math::Vector<realT, 3>>& lhs,
+                     const std::vector<mjolnir::math::Vector<realT, 3>>& rhs,
+                     const realT threshold_sq)
+{
+    return detail::any_pair_within_scalar(
+            lhs.data(), lhs.size(), rhs.data(), rhs.size(), threshold_sq);
+}
+
+// ----------------------------------------------------------------------------
+// SIMD version for double precision. It is selected at compile time if the
+// target supports AVX or SSE2. Define JARNGREIPR_WITHOUT_SIMD to disable it.
+// x86-64 always has SSE2; the AVX kernel needs -mavx or -march=native.
+//
+// It calculates dx*dx + dy*dy + dz*dz in the same order as the scalar
+// version without FMA, so the result is exactly the same.
+
+#if !defined(JARNGREIPR_WITHOUT_SIMD) && defined(__AVX__)
+
+inline bool any_pair_within(const std::vector<mjolnir::math::Vector<double, 3>>& lhs,
+                            const std::vector<mjolnir::math::Vector<double, 3>>& rhs,
+                            const double threshold_sq)
+{
+    const __m256d th2 = _mm256_set1_pd(threshold_sq);
+
+    std::size_t j = 0;
+    for(; j + 4 <= rhs.size(); j += 4)
+    {
+        const __m256d x2 = _mm256_set_pd(rhs[j+3][0], rhs[j+2][0], rhs[j+1][0], rhs[j][0]);
+        const __m256d y2 = _mm256_set_pd(rhs[j+3][1], rhs[j+2][1], rhs[j+1][1], rhs[j][1]);
+        const __m256d z2 = _mm256_set_pd(rhs[j+3][2], rhs[j+2][2], rhs[j+1][2], rhs[j][2]);
+        for(const auto& p1 : lhs)
+        {
+            const __m256d dx = _mm256_sub_pd(_mm256_set1_pd(p1[0]), x2);
+            const __m256d dy = _mm256_sub_pd(_mm256_set1_pd(p1[1]), y2);
+            const __m256d dz = _mm256_sub_pd(_mm256_set1_pd(p1[2]), z2);
+            const __m256d d2 = _mm256_add_pd(_mm256_add_pd(
+                    _mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)),
+                    _mm256_mul_pd(dz, dz));
+            if(_mm256_movemask_pd(_mm256_cmp_pd(d2, th2, _CMP_LT_OQ)) != 0)
+            {
+                return true;
+            }
+        }
+    }
+    return detail::any_pair_within_scalar(lhs.data(), lhs.size(),
+            rhs.data() + j, rhs.size() - j, threshold_sq);
+}
+
+#elif !defined(JARNGREIPR_WITHOUT_SIMD) && defined(__SSE2__)
+
+inline bool any_pair_within(const std::vector<mjolnir::math::Vector<double, 3>>& lhs,
+                            const std::vector<mjolnir::math::Vector<double, 3>>& rhs,
+                            const double threshold_sq)
+{
+    const __m128d th2 = _mm_set1_pd(threshold_sq);
+
+    std::size_t j = 0;
+    for(; j + 2 <= rhs.size(); j += 2)
+    {
+        const __m128d x2 = _mm_set_pd(rhs[j+1][0], rhs[j][0]);
+        const __m128d y2 = _mm_set_pd(rhs[j+1][1], rhs[j][1]);
+        const __m128d z2 = _mm_set_pd(rhs[j+1][2], rhs[j][2]);
+        for(const auto& p1 : lhs)
+        {
+            const __m128d dx = _mm_sub_pd(_mm_set1_pd(p1[0]), x2);
+            const __m128d dy = _mm_sub_pd(_mm_set1_pd(p1[1]), y2);
+            const __m128d dz = _mm_sub_pd(_mm_set1_pd(p1[2]), z2);
+            const __m128d d2 = _mm_add_pd(_mm_add_pd(
+                    _mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz));
+            if(_mm_movemask_pd(_mm_cmplt_pd(d2, th2)) != 0)
+            {
+                return true;
+            }
+        }
+    }
+    return detail::any_pair_within_scalar(lhs.data(), lhs.size(),
+            rhs.data() + j, rhs.size() - j, threshold_sq);
+}
+
+#endif
+
+} // jarngreipr
+#endif /* JARNGREIPR_GEOMETRY_MIN_DISTANCE */
@@ -0,0 +1,93 @@
+#ifndef JARNGREIPR_GEOMETRY_RIGID_COPY_HPP
+#define JARNGREIPR_GEOMETRY_RIGID_COPY_HPP
+#include <jarngreipr/geometry/distance.hpp>
+#include <array>
+#include <vector>
+#include <cmath>
+
+namespace jarngreipr
+{
+
+// check whether `rhs` is `lhs` moved by a rotation and a translation, within
+// `tolerance` for each point. Mirror images are not regarded as copies.
+//
+// A local frame is built from 3 points of each set: the first point, the
+// point farthest from it, and the point farthest from the line through them.
+// All the points are expressed in the frame and compared one by one.
+template<typename realT>
+bool is_rigid_copy(const std::vector<mjolnir::math::Vector<realT, 3>>& lhs,
+                   const std::vector<mjolnir::math::Vector<realT, 3>>& rhs,
+                   const realT tolerance)
+{
+    using coordinate_type = mjolnir::math::Vector<realT, 3>;
+    using mjolnir::math::cross_product;
+    using mjolnir::math::dot_product;
+    using mjolnir::math::length;
+
+    if(lhs.size() != rhs.size()) {return false;}
+    if(lhs.empty())              {return true;}
+
+    // choose the anchor points using lhs, and apply them to both.
+    std::size_t a = 0, b = 0, c = 0;
+    realT max_dist = 0;
+    for(std::size_t i=1; i<lhs.size(); ++i)
+    {
+        const auto d = distance_sq(lhs[a], lhs[i]);
+        if(max_dist < d) {max_dist = d; b = i;}
+    }
+    if(b == a)
+    {
+        return distance_sq(lhs[a], rhs[a]) <= tolerance * tolerance;
+    }
+    max_dist = 0;
+    for(std::size_t i=1; i<lhs.size(); ++i)
+    {
+        const auto d = length(cross_product(lhs[b] - lhs[a], lhs[i] - lhs[a]));
+        if(max_dist < d) {max_dist = d; c = i;}
+    }
+    // all the points are on a line, so the rotation around it is arbitrary.
+    // Compare the positions along the line and the distances from it.
+    const bool collinear = (max_dist <= tolerance * length(lhs[b] - lhs[a]));
+
+    const auto make_frame = [&](const std::vector<coordinate_type>& ps)
+        -> std::array<coordinate_type, 3>
+    {
+        const auto e1 = (ps[b] - ps[a]) / length(ps[b] - ps[a]);
+        if(collinear) {return {{e1, e1, e1}};}
+        auto e2 = (ps[c] - ps[a]) - dot_product(ps[c] - ps[a], e1) * e1;
+        e2 = e2 / length(e2);
+        return {{e1, e2, cross_product(e1, e2)}};
+    };
+    const auto lframe = make_frame(lhs);
+    const auto rframe = make_frame(rhs);
+
+    for(std::size_t i=0; i<lhs.size(); ++i)
+    {
+        const auto l = lhs[i] - lhs[a];
+        const auto r = rhs[i] - rhs[a];
+        if(collinear)
+        {
+            const auto l1 = dot_product(l, lframe[0]);
+            const auto r1 = dot_product(r, rframe[0]);
+            const auto l2 = length(l - l1 * lframe[0]);
+            const auto r2 = length(r - r1 * rframe[0]);
+            // written in this way to reject NaN, e.g. from a degenerated frame.
+            if(!(std::abs(l1 - r1) <= tolerance && std::abs(l2 - r2) <= tolerance))
+            {
+                return false;
+            }
+            continue;
+        }
+        realT diff_sq = 0;
+        for(std::size_t k=0; k<3; ++k)
+        {
+            const auto d = dot_product(l, lframe[k]) - dot_product(r, rframe[k]);
+            diff_sq += d * d;
+        }
+        if(!(diff_sq <= tolerance * tolerance)) {return false;}
+    }
+    return true;
+}
+
+} // jarngreipr
+#endif// JARNGREIPR_GEOMETRY_RIGID_COPY_HPP
@@ -0,0 +1,192 @@
+#ifndef JARNGREIPR_MMCIF_CIF_TOKENIZER_HPP
+#define JARNGREIPR_MMCIF_CIF_TOKENIZER_HPP
+#include <jarngreipr/util/source_location.hpp>
+#include <jarngreipr/util/log.hpp>
+#include <algorithm>
+#include <string>
+#include <cstring>
+
+namespace jarngreipr
+{
+
+// a token in a CIF file. It refers to the file contents without copying.
+struct CIFToken
+{
+    const char* first;      // value, without quotes
+    const char* last;
+    const char* raw_first;  // including quotes or semicolons
+    const char* raw_last;
+    const char* line;       // beginning of the line that contains the token
+    std::size_t line_num;
+    bool        quoted;     // quoted values are never keywords or tags
+
+    std::size_t size() const noexcept {return last - first;}
+    std::string str()  const {return std::string(first, last);}
+
+    bool equals(const char* s) const noexcept
+    {
+        const std::size_t len = std::strlen(s);
+        return len == this->size() && std::equal(s, s + len, first);
+    }
+    bool starts_with(const char* s) const noexcept
+    {
+        const std::size_t len = std::strlen(s);
+        return len <= this->size() && std::equal(s, s + len, first);
+    }
+
+    // `.` and `?` represent inapplicable and unknown values, respectively.
+    bool is_null() const noexcept
+    {
+        return !quoted && size() == 1 && (*first == '.' || *first == '?');
+    }
+    // data_, loop_, save_, global_, stop_, or a tag like _atom_site.id.
+    bool is_reserved() const noexcept
+    {
+        return !quoted && (*first == '_' || starts_with("data_") ||
+               equals("loop_") || starts_with("save_") ||
+               equals("global_") || equals("stop_"));
+    }
+};
+
+// split [first, last) into CIF tokens. It handles comments, quoted strings,
+// and semicolon-delimited text fields.
+class CIFTokenizer
+{
+  public:
+
+    // `file_begin` is used to find the beginning of the first line.
+    CIFTokenizer(const std::string& filename, const char* file_begin,
+                 const char* first, const char* last, std::size_t line_num = 1)
+        : iter_(first), last_(last), line_(first), line_num_(line_num),
+          filename_(filename)
+    {
+        while(file_begin < line_ && *(line_ - 1) != '\n') {--line_;}
+    }
+
+    // returns false if there are no more tokens.
+    bool next(CIFToken& tk)
+    {
+        while(iter_ != last_)
+        {
+            const char c = *iter_;
+            if(c == '\n')
+            {
+                ++iter_;
+                line_ = iter_;
+                ++line_num_;
+            }
+            else if(c == ' ' || c == '\t' || c == '\r')
+            {
+                ++iter_;
+            }
+            else if(c == '#')
+            {
+                iter_ = std::find(iter_, last_, '\n');
+            }
+            else if(c == ';' && iter_ == line_)
+            {
+                return this->read_text_field(tk);
+            }
+            else if(c == '\'' || c == '"')
+            {
+                return this->read_quoted(tk);
+            }
+            else
+            {
+                const char* beg = iter_;
+                while(iter_ != last_ && !is_space(*iter_)) {++iter_;}
+                tk = CIFToken{beg, iter_, beg, iter_, line_, line_num_, false};
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* position() const noexcept {return iter_;}
+
+    source_location location(const CIFToken& tk) const
+    {
+        const char* eol = std::find(tk.line, last_, '\n');
+        const std::size_t first = (tk.first < eol) ? tk.first - tk.line : 0;
+        const std::size_t range = std::max<std::size_t>(1,
+                std::min(tk.last, eol) - std::min(tk.first, eol));
+        return source_location(filename_, std::string(tk.line, eol),
+                               first, range, tk.line_num);
+    }
+
+  private:
+
+    static bool is_space(const char c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    // 'a quoted string'. A quote followed by a non-space is a part of it.
+    bool read_quoted(CIFToken& tk)
+    {
+        const char  q   = *iter_;
+        const char* beg = iter_;
+        const char* end = iter_ + 1;
+        while(end != last_ && !(*end == q && (end + 1 == last_ || is_space(end[1]))))
+        {
+            if(*end == '\n')
+            {
+                tk = CIFToken{beg, end, beg, end, line_, line_num_, true};
+                log::error("CIFTokenizer: quoted string is not closed",
+                           this->location(tk), "here");
+                std::terminate();
+            }
+            ++end;
+        }
+        if(end == last_)
+        {
+            tk = CIFToken{beg, end, beg, end, line_, line_num_, true};
+            log::error("CIFTokenizer: quoted string is not closed",
+                       this->location(tk), "here");
+            std::terminate();
+        }
+        tk = CIFToken{beg + 1, end, beg, end + 1, line_, line_num_, true};
+        iter_ = end + 1;
+        return true;
+    }
+
+    // ;text field that may contain newlines
+    // ;
+    bool read_text_field(CIFToken& tk)
+    {
+        const char* beg = iter_;
+        const char* end = iter_ + 1;
+        const std::size_t line_num = line_num_;
+        const char* const line     = line_;
+        while(true)
+        {
+            end = std::find(end, last_, '\n');
+            if(end == last_)
+            {
+                tk = CIFToken{beg, beg + 1, beg, beg + 1, line, line_num, true};
+                log::error("CIFTokenizer: text field is not closed",
+                           this->location(tk), "here");
+                std::terminate();
+            }
+            ++line_num_;
+            ++end;
+            line_ = end;
+            if(end != last_ && *end == ';') {break;}
+        }
+        // the newline just before the closing semicolon is not a part of it.
+        tk = CIFToken{beg + 1, end - 1, beg, end + 1, line, line_num, true};
+        iter_ = end + 1;
+        return true;
+    }
+
+  private:
+
+    const char* iter_;
+    const char* last_;
+    const char* line_;     // beginning of the current line
+    std::size_t line_num_;
+    std::string const& filename_;
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_MMCIF_CIF_TOKENIZER_HPP
@@ -0,0 +1,389 @@
+#ifndef JARNGREIPR_MMCIF_READER_HPP
+#define JARNGREIPR_MMCIF_READER_HPP
+#include <jarngreipr/mmcif/CIFTokenizer.hpp>
+#include <jarngreipr/pdb/StructureReaderBase.hpp>
+#include <jarngreipr/pdb/PDBAtom.hpp>
+#include <jarngreipr/pdb/PDBChain.hpp>
+#include <jarngreipr/util/mapped_file.hpp>
+#include <jarngreipr/util/parse_number.hpp>
+#include <jarngreipr/util/log.hpp>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdlib>
+
+namespace jarngreipr
+{
+
+// lazy mmCIF (PDBx) reader. It reads ATOM records in the `_atom_site` loop
+// into PDBAtoms, so the model generators can use it in the same way as
+// PDBReader.
+//
+// Values are converted to the pdb format; atom names are aligned as the pdb
+// columns (e.g. " CA "), and auth_* values are used if they exist. Chain IDs
+// are kept as they are, so a chain can have a multi-letter ID.
+//
+// On construction, it scans the loop to find the rows of each chain.
+// read_chain parses only the rows of the requested chain.
+template<typename realT>
+class MMCIFReader final : public StructureReaderBase<realT>
+{
+  public:
+    using base_type  = StructureReaderBase<realT>;
+    using real_type  = typename base_type::real_type;
+    using chain_type = typename base_type::chain_type;
+    using chain_ptr  = typename base_type::chain_ptr;
+    using atom_type  = PDBAtom<real_type>;
+    using key_type   = std::pair<std::int32_t, std::string>; // {model, chain ID}
+
+  public:
+
+    explicit MMCIFReader(const std::string& fname, const std::size_t num_threads = 1)
+        : base_type(num_threads), filename_(fname), file_(fname)
+    {
+        this->scan_atom_site();
+    }
+    ~MMCIFReader() override = default;
+
+    chain_ptr read_chain(const std::string& id) override
+    {
+        const auto found = this->first_model_.find(id);
+        if(found == this->first_model_.end())
+        {
+            log::error("MMCIFReader: file \"", filename_, "\" does not "
+                       "contain chain ", id, ".\n");
+            std::terminate();
+        }
+        return this->read_chain(id, found->second);
+    }
+    chain_ptr read_chain(const std::string& id, const std::int32_t model) override
+    {
+        const key_type key(model, id);
+        const auto cached = this->chains_.find(key);
+        if(cached != this->chains_.end())
+        {
+            return cached->second;
+        }
+        const auto found = this->blocks_.find(key);
+        if(found == this->blocks_.end())
+        {
+            log::error("MMCIFReader: file \"", filename_, "\" does not "
+                       "contain chain ", id, " in model ", model, ".\n");
+            std::terminate();
+        }
+
+        std::vector<atom_type> atoms;
+        for(const auto& block : found->second)
+        {
+            this->parse_block(block, atoms);
+        }
+        log::info("MMCIFReader: read chain ", id, ".\n");
+
+        auto chain = std::make_shared<const chain_type>(std::move(atoms));
+        this->chains_.emplace(key, chain);
+        return chain;
+    }
+
+    std::vector<std::int32_t> models() const override {return models_;}
+
+  private:
+
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    // rows [first, last) in the loop that belong to the same chain.
+    struct block_type
+    {
+        const char* first;
+        const char* last;
+        std::size_t line;
+    };
+
+    // column indices of the _atom_site loop. npos if it does not exist.
+    struct columns_type
+    {
+        std::size_t group, id, type_symbol, atom_name, alt_id, comp_id,
+                    asym_id, seq_id, ins_code, x, y, z, occupancy, b_factor,
+                    charge, model;
+    };
+
+    void scan_atom_site()
+    {
+        CIFTokenizer tokenizer(filename_, file_.begin(), file_.begin(), file_.end());
+        CIFToken tk;
+
+        // find `loop_` followed by `_atom_site.` tags.
+        std::vector<std::string> tags;
+        bool has_token = tokenizer.next(tk);
+        while(has_token)
+        {
+            if(!(tk.equals("loop_") && !tk.quoted))
+            {
+                has_token = tokenizer.next(tk);
+                continue;
+            }
+            tags.clear();
+            while((has_token = tokenizer.next(tk)) && !tk.quoted && *tk.first == '_')
+            {
+                tags.push_back(tk.str());
+            }
+            if(!tags.empty() && tags.front().compare(0, 11, "_atom_site.") == 0)
+            {
+                break;
+            }
+            tags.clear();
+        }
+        if(tags.empty())
+        {
+            log::error("MMCIFReader: file \"", filename_, "\" does not have "
+                       "_atom_site loop.\n");
+            std::terminate();
+        }
+        this->num_columns_ = tags.size();
+        this->set_columns(tags);
+
+        // split rows into chains. HETATM rows are skipped later.
+        const char*  row_first = nullptr;
+        std::size_t  row_line  = 0;
+        std::size_t  col       = 0;
+        bool         is_atom   = true;
+        std::int32_t model     = 1;
+        std::string  asym_id;
+        block_type*  current   = nullptr;
+        key_type     current_key;
+        for(; has_token && !tk.is_reserved(); has_token = tokenizer.next(tk), ++col)
+        {
+            if(col == this->num_columns_) {col = 0;}
+            if(col == 0)
+            {
+                row_first = tk.raw_first;
+                row_line  = tk.line_num;
+            }
+            if(col == columns_.group)
+            {
+                is_atom = tk.equals("ATOM");
+            }
+            else if(col == columns_.asym_id)
+            {
+                asym_id.assign(tk.first, tk.last);
+            }
+            else if(col == columns_.model)
+            {
+                if(!parse_integer(tk.first, tk.last, model))
+                {
+                    log::error("MMCIFReader: invalid model number",
+                               tokenizer.location(tk), "here");
+                    std::terminate();
+                }
+            }
+
+            if(col + 1 != this->num_columns_ || !is_atom) {continue;}
+
+            if(current && current_key.first == model && current_key.second == asym_id)
+            {
+                current->last = tk.raw_last;
+                continue;
+            }
+            current_key = key_type(model, asym_id);
+            auto& blocks = this->blocks_[current_key];
+            blocks.push_back(block_type{row_first, tk.raw_last, row_line});
+            current = std::addressof(blocks.back());
+            this->first_model_.emplace(asym_id, model);
+            if(std::find(models_.begin(), models_.end(), model) == models_.end())
+            {
+                this->models_.push_back(model);
+            }
+        }
+        if(col != 0 && col != this->num_columns_)
+        {
+            log::error("MMCIFReader: file \"", filename_, "\" has an "
+                       "incomplete row in _atom_site loop.\n");
+            std::terminate();
+        }
+        return;
+    }
+
+    void set_columns(const std::vector<std::string>& tags)
+    {
+        const auto find = [&tags](const char* name) -> std::size_t {
+            const auto found = std::find(tags.begin(), tags.end(),
+                                         std::string("_atom_site.") + name);
+            return (found == tags.end()) ? npos : found - tags.begin();
+        };
+        const auto either = [](std::size_t auth, std::size_t label) {
+            return (auth != npos) ? auth : label;
+        };
+        const auto require = [this](std::size_t col, const char* name) {
+            if(col == npos)
+            {
+                log::error("MMCIFReader: file \"", filename_, "\" lacks "
+                           "_atom_site.", name, ".\n");
+                std::terminate();
+            }
+            return col;
+        };
+
+        columns_.group       = find("group_PDB");
+        columns_.id          = require(find("id"), "id");
+        columns_.type_symbol = find("type_symbol");
+        columns_.atom_name   = require(either(find("auth_atom_id"),
+                                 find("label_atom_id")), "label_atom_id");
+        columns_.alt_id      = find("label_alt_id");
+        columns_.comp_id     = require(either(find("auth_comp_id"),
+                                 find("label_comp_id")), "label_comp_id");
+        columns_.asym_id     = require(either(find("auth_asym_id"),
+                                 find("label_asym_id")), "label_asym_id");
+        columns_.seq_id      = require(either(find("auth_seq_id"),
+                                 find("label_seq_id")), "label_seq_id");
+        columns_.ins_code    = find("pdbx_PDB_ins_code");
+        columns_.x           = require(find("Cartn_x"), "Cartn_x");
+        columns_.y           = require(find("Cartn_y"), "Cartn_y");
+        columns_.z           = require(find("Cartn_z"), "Cartn_z");
+        columns_.occupancy   = find("occupancy");
+        columns_.b_factor    = find("B_iso_or_equiv");
+        columns_.charge      = find("pdbx_formal_charge");
+        columns_.model       = find("pdbx_PDB_model_num");
+        return;
+    }
+
+    void parse_block(const block_type& block, std::vector<atom_type>& atoms) const
+    {
+        CIFTokenizer tokenizer(filename_, file_.begin(),
+                               block.first, block.last, block.line);
+        std::vector<CIFToken> row(this->num_columns_);
+        while(true)
+        {
+            for(std::size_t i=0; i<this->num_columns_; ++i)
+            {
+                if(!tokenizer.next(row[i]))
+                {
+                    return; // the block consists of complete rows.
+                }
+            }
+            if(columns_.group != npos && !row[columns_.group].equals("ATOM"))
+            {
+                continue;
+            }
+            atoms.push_back(this->read_atom(tokenizer, row));
+        }
+    }
+
+    atom_type read_atom(const CIFTokenizer& tokenizer,
+                        const std::vector<CIFToken>& row) const
+    {
+        atom_type atm;
+        const std::string element = (columns_.type_symbol != npos &&
+            !row[columns_.type_symbol].is_null()) ?
+            row[columns_.type_symbol].str() : std::string("");
+
+        atm.atom_id      = read_number<std::int32_t>(tokenizer, row[columns_.id]);
+        atm.atom_name    = format_atom_name(row[columns_.atom_name].str(), element);
+        atm.altloc       = read_char(row, columns_.alt_id);
+        atm.residue_name = right_justify(row[columns_.comp_id].str(), 3);
+        atm.chain_id     = row[columns_.asym_id].str();
+        atm.residue_id   = read_number<std::int32_t>(tokenizer, row[columns_.seq_id]);
+        atm.icode        = read_char(row, columns_.ins_code);
+        atm.position[0]  = read_number<real_type>(tokenizer, row[columns_.x]);
+        atm.position[1]  = read_number<real_type>(tokenizer, row[columns_.y]);
+        atm.position[2]  = read_number<real_type>(tokenizer, row[columns_.z]);
+
+        if(atm.altloc != ' ')
+        {
+            log::warn("mmCIF atom has alternative location code. "
+                      "It may cause invalid parameters.\n");
+            log::warn(tokenizer.location(row[columns_.alt_id]), '\n');
+        }
+
+        atm.occupancy          = read_optional_number(tokenizer, row, columns_.occupancy);
+        atm.temperature_factor = read_optional_number(tokenizer, row, columns_.b_factor);
+        atm.element            = right_justify(element, 2);
+        atm.charge             = "  ";
+
+        if(columns_.charge != npos && !row[columns_.charge].is_null())
+        {
+            // "+2" in mmCIF corresponds to "2+" in pdb.
+            const std::int32_t charge =
+                read_number<std::int32_t>(tokenizer, row[columns_.charge]);
+            if(charge != 0 && -10 < charge && charge < 10)
+            {
+                atm.charge = std::string(1, static_cast<char>('0' + std::abs(charge))) +
+                             (charge < 0 ? '-' : '+');
+            }
+        }
+        return atm;
+    }
+
+    template<typename T>
+    static T read_number(const CIFTokenizer& tokenizer, const CIFToken& tk)
+    {
+        T value;
+        if(!parse_number(tk.first, tk.last, value))
+        {
+            log::error("read_number: invalid number format",
+                       tokenizer.location(tk), "here");
+            std::terminate();
+        }
+        return value;
+    }
+    real_type read_optional_number(const CIFTokenizer& tokenizer,
+        const std::vector<CIFToken>& row, const std::size_t col) const
+    {
+        if(col == npos || row[col].is_null()) {return 0.0;}
+        return read_number<real_type>(tokenizer, row[col]);
+    }
+    static char read_char(const std::vector<CIFToken>& row, const std::size_t col)
+    {
+        if(col == npos || row[col].is_null() || row[col].size() == 0) {return ' ';}
+        return *row[col].first;
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value, bool>::type
+    parse_number(const char* first, const char* last, T& value)
+    {
+        return parse_integer(first, last, value);
+    }
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+    parse_number(const char* first, const char* last, T& value)
+    {
+        return parse_real(first, last, value);
+    }
+
+    static std::string right_justify(const std::string& str, const std::size_t width)
+    {
+        if(width <= str.size()) {return str;}
+        return std::string(width - str.size(), ' ') + str;
+    }
+
+    // in pdb, the element symbol of an atom name is right-justified in the
+    // first 2 columns, like " CA " (C-alpha) and "CA  " (calcium).
+    static std::string format_atom_name(std::string name, const std::string& element)
+    {
+        if(4 <= name.size()) {return name;}
+        if(element.size() != 2) {name = ' ' + name;}
+        name.resize(4, ' ');
+        return name;
+    }
+
+  private:
+
+    std::string  filename_;
+    mapped_file  file_;
+    std::size_t  num_columns_;
+    columns_type columns_;
+
+    std::map<key_type, std::vector<block_type>> blocks_;
+    std::map<std::string, std::int32_t>         first_model_;
+    std::vector<std::int32_t>                   models_;
+
+    // store chains already read
+    std::map<key_type, chain_ptr> chains_;
+};
+template<typename realT>
+constexpr std::size_t MMCIFReader<realT>::npos;
+
+} // jarngreipr
+#endif// JARNGREIPR_MMCIF_READER_HPP
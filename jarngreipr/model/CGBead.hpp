@@ -1,13 +1,48 @@
 #ifndef JARNGREIPR_MODEL_CGBEAD_HPP
 #define JARNGREIPR_MODEL_CGBEAD_HPP
-#include <jarngreipr/pdb/PDBAtom.hpp>
+#include <jarngreipr/pdb/PDBAtomView.hpp>
+#include <jarngreipr/pdb/remove_hydrogens.hpp>
+#include <jarngreipr/pdb/atom_class.hpp>
 #include <vector>
 #include <string>
 #include <map>
+#include <ostream>
+#include <cstdint>
 
 namespace jarngreipr
 {
 
+// kind of a CG bead. Each bead class has its kind as a static constant
+// `bead_kind`, so a generator that accepts only one kind of beads can check
+// it without a virtual call or a string comparison.
+enum class CGBeadKind : std::uint8_t
+{
+    CarbonAlpha        = 0,
+    ThreeSPN2Base      = 1,
+    ThreeSPN2Sugar     = 2,
+    ThreeSPN2Phosphate = 3
+};
+
+inline std::string to_string(const CGBeadKind kind)
+{
+    switch(kind)
+    {
+        case CGBeadKind::CarbonAlpha:        {return "CarbonAlpha";}
+        case CGBeadKind::ThreeSPN2Base:      {return "3SPN2Base";}
+        case CGBeadKind::ThreeSPN2Sugar:     {return "3SPN2Sugar";}
+        case CGBeadKind::ThreeSPN2Phosphate: {return "3SPN2Phosphate";}
+        default: {return "unknown";}
+    }
+}
+
+template<typename charT, typename traits>
+std::basic_ostream<charT, traits>&
+operator<<(std::basic_ostream<charT, traits>& os, const CGBeadKind kind)
+{
+    os << to_string(kind);
+    return os;
+}
+
 template<typename realT>
 class CGBead
 {
@@ -15,33 +50,83 @@ class CGBead
     using real_type = realT;
     using atom_type = PDBAtom<real_type>;
     using coordinate_type = typename atom_type::coordinate_type;
-    using container_type  = std::vector<atom_type>;
+    using container_type  = PDBAtomView<real_type>; // refers to a PDBChain
 
   public:
 
-    CGBead(std::size_t index, real_type mass, container_type atoms, std::string name)
-        : index_(index), mass_(mass), name_(std::move(name)), atoms_(std::move(atoms))
-    {}
+    CGBead(CGBeadKind kind, std::size_t index, real_type mass,
+           container_type atoms, std::string name)
+        : kind_(kind), index_(index), mass_(mass), name_(std::move(name)),
+          residue_id_(0), atoms_(std::move(atoms))
+    {
+        if(!this->atoms_.empty())
+        {
+            this->residue_id_ = this->atoms_.front().residue_id;
+        }
+        // contact calculations look only at heavy atoms. keep their positions
+        // in a contiguous array not to copy the atoms for every pair of beads.
+        for(std::size_t i=0; i<this->atoms_.size(); ++i)
+        {
+            if(!is_hydrogen(this->atoms_[i]))
+            {
+                this->heavy_atom_indices_.push_back(i);
+                this->heavy_positions_   .push_back(this->atoms_[i].position);
+                this->heavy_atom_classes_.push_back(classify_atom(this->atoms_[i]));
+            }
+        }
+    }
     virtual ~CGBead() = default;
 
     virtual coordinate_type position() const = 0;
-    virtual std::string kind() const = 0;
+    CGBeadKind kind() const noexcept {return kind_;}
 
     container_type const& atoms() const noexcept {return atoms_;}
     std::string    const& name()  const noexcept {return name_;}
     std::size_t    const& index() const noexcept {return index_;}
     real_type      const& mass()  const noexcept {return mass_;}
 
+    // residue ID of the first atom.
+    std::int32_t residue_id() const noexcept {return residue_id_;}
+
+    // i-th heavy atom is `atoms()[heavy_atom_indices()[i]]` and is located at
+    // `heavy_positions()[i]`.
+    std::vector<std::size_t>     const& heavy_atom_indices() const noexcept
+    {return heavy_atom_indices_;}
+    std::vector<coordinate_type> const& heavy_positions()    const noexcept
+    {return heavy_positions_;}
+    // bitmask of atom_class::flag for each heavy atom.
+    std::vector<std::uint8_t>    const& heavy_atom_classes() const noexcept
+    {return heavy_atom_classes_;}
+
     bool has_attribute(const std::string& key) const {return attr_.count(key) == 1;}
     std::string const& attribute(const std::string& key) const {return attr_.at(key);}
     std::string&       attribute(const std::string& key)       {return attr_[key];}
+    std::map<std::string, std::string> const& attributes() const noexcept
+    {return attr_;}
+
+  protected:
+
+    // a bead without atoms, e.g. restored from a cache. atoms() and
+    // heavy_atom_indices() are empty.
+    CGBead(CGBeadKind kind, std::size_t index, real_type mass, std::string name,
+           std::int32_t residue_id, std::vector<coordinate_type> heavy_positions,
+           std::vector<std::uint8_t> heavy_atom_classes)
+        : kind_(kind), index_(index), mass_(mass), name_(std::move(name)),
+          residue_id_(residue_id), heavy_positions_(std::move(heavy_positions)),
+          heavy_atom_classes_(std::move(heavy_atom_classes))
+    {}
 
   protected:
 
+    CGBeadKind      kind_;
     std::size_t     index_;
     real_type       mass_;
     std::string     name_;
+    std::int32_t    residue_id_;
     container_type  atoms_;
+    std::vector<std::size_t>     heavy_atom_indices_;
+    std::vector<coordinate_type> heavy_positions_;
+    std::vector<std::uint8_t>    heavy_atom_classes_;
     std::map<std::string, std::string> attr_;
 };
 
@@ -0,0 +1,97 @@
+#ifndef JARNGREIPR_MODEL_CG_BEAD_TABLE_HPP
+#define JARNGREIPR_MODEL_CG_BEAD_TABLE_HPP
+#include <jarngreipr/model/CGBead.hpp>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <string>
+#include <utility>
+
+namespace jarngreipr
+{
+
+//
+// A flat, structure-of-arrays cache of the per-bead values that are frequently
+// read by ForceFieldGenerators.
+//
+// CGBead is a polymorphic object allocated separately and `position()` is a
+// virtual call. Generators that loop over many beads can read the values from
+// contiguous arrays instead. The k-th element of each array corresponds to the
+// k-th bead in the chain. Names are stored as IDs into `names()` to avoid
+// keeping a string per bead.
+//
+// This is an additional copy, not the storage of the beads; CGChain still
+// owns the beads through shared_ptrs and the table costs extra memory. It is
+// only valid because the cached values do not change after a bead is
+// constructed. Values that no generator reads in its inner loops, e.g. mass,
+// are not cached.
+//
+template<typename realT>
+class CGBeadTable
+{
+  public:
+    using real_type       = realT;
+    using bead_type       = CGBead<real_type>;
+    using coordinate_type = typename bead_type::coordinate_type;
+    using id_type         = std::uint32_t;
+
+  public:
+
+    CGBeadTable()  = default;
+    ~CGBeadTable() = default;
+    CGBeadTable(const CGBeadTable&) = default;
+    CGBeadTable(CGBeadTable&&)      = default;
+    CGBeadTable& operator=(const CGBeadTable&) = default;
+    CGBeadTable& operator=(CGBeadTable&&)      = default;
+
+    void push_back(const bead_type& bead)
+    {
+        this->positions_.push_back(bead.position());
+        this->indices_  .push_back(bead.index());
+        this->kinds_    .push_back(bead.kind());
+        this->name_ids_ .push_back(this->intern(bead.name()));
+        return;
+    }
+
+    bool       empty() const noexcept {return indices_.empty();}
+    std::size_t size() const noexcept {return indices_.size();}
+
+    coordinate_type const& position(const std::size_t i) const noexcept {return positions_[i];}
+    std::size_t     const& index   (const std::size_t i) const noexcept {return indices_[i];}
+    CGBeadKind      const& kind    (const std::size_t i) const noexcept {return kinds_[i];}
+    std::string     const& name    (const std::size_t i) const noexcept {return names_[name_ids_[i]];}
+
+    std::vector<coordinate_type> const& positions() const noexcept {return positions_;}
+    std::vector<std::size_t>     const& indices()   const noexcept {return indices_;}
+    std::vector<CGBeadKind>      const& kinds()     const noexcept {return kinds_;}
+    std::vector<id_type>         const& name_ids()  const noexcept {return name_ids_;}
+
+    // unique names appeared in the table.
+    std::vector<std::string> const& names() const noexcept {return names_;}
+
+  private:
+
+    id_type intern(const std::string& name)
+    {
+        const auto inserted = this->name_to_id_.insert(
+            std::make_pair(name, static_cast<id_type>(this->names_.size())));
+        if(inserted.second)
+        {
+            this->names_.push_back(name);
+        }
+        return inserted.first->second;
+    }
+
+  private:
+
+    std::vector<coordinate_type> positions_;
+    std::vector<std::size_t>     indices_;
+    std::vector<CGBeadKind>      kinds_;
+    std::vector<id_type>         name_ids_;
+
+    std::vector<std::string>       names_;
+    std::map<std::string, id_type> name_to_id_;
+};
+
+}//jarngreipr
+#endif // JARNGREIPR_MODEL_CG_BEAD_TABLE_HPP
@@ -1,12 +1,21 @@
 #ifndef JARNGREIPR_MODEL_CG_CHAIN_H
 #define JARNGREIPR_MODEL_CG_CHAIN_H
 #include <jarngreipr/model/CGBead.hpp>
+#include <jarngreipr/model/CGBeadTable.hpp>
 #include <vector>
 #include <memory>
 
 namespace jarngreipr
 {
 
+//
+// A chain of CG beads, with name.
+//
+// In addition to the beads, it keeps a flat cache of frequently used values
+// (see CGBeadTable.hpp). The beads remain the primary storage. Beads can be appended but not replaced, so that the
+// table is always consistent with the beads. Attributes of a bead can still be
+// modified through the pointer.
+//
 template<typename realT>
 class CGChain
 {
@@ -14,8 +23,9 @@ class CGChain
     using real_type = realT;
     using bead_type = CGBead<real_type>;
     using bead_ptr  = std::shared_ptr<bead_type>;
+    using table_type     = CGBeadTable<real_type>;
     using container_type = std::vector<bead_ptr>;
-    using iterator       = typename container_type::iterator;
+    using iterator       = typename container_type::const_iterator;
     using const_iterator = typename container_type::const_iterator;
 
   public:
@@ -32,33 +42,30 @@ class CGChain
     std::size_t size() const noexcept {return beads_.size();}
 
     void push_back(const std::shared_ptr<bead_type>& b)
-    {beads_.push_back(b);}
+    {beads_.push_back(b); table_.push_back(*beads_.back());}
     void push_back(std::shared_ptr<bead_type>&& b)
-    {beads_.push_back(std::move(b));}
+    {beads_.push_back(std::move(b)); table_.push_back(*beads_.back());}
 
     template<typename ... Ts>
     void emplace_back(Ts&& ... ts)
-    {beads_.emplace_back(std::forward<Ts>(ts)...);}
+    {
+        beads_.emplace_back(std::forward<Ts>(ts)...);
+        table_.push_back(*beads_.back());
+    }
 
-    bead_ptr&       operator[](const std::size_t i)       noexcept {return beads_[i];}
     bead_ptr const& operator[](const std::size_t i) const noexcept {return beads_[i];}
-    bead_ptr&       at(const std::size_t i)       {return beads_.at(i);}
     bead_ptr const& at(const std::size_t i) const {return beads_.at(i);}
 
-    iterator       begin()        noexcept {return beads_.begin();}
-    iterator       end()          noexcept {return beads_.end();}
     const_iterator begin()  const noexcept {return beads_.begin();}
     const_iterator end()    const noexcept {return beads_.end();}
     const_iterator cbegin() const noexcept {return beads_.cbegin();}
     const_iterator cend()   const noexcept {return beads_.cend();}
 
-    bead_ptr&       front()       noexcept {return beads_.front();}
     bead_ptr const& front() const noexcept {return beads_.front();}
-    bead_ptr&       back()        noexcept {return beads_.back();}
     bead_ptr const& back()  const noexcept {return beads_.back();}
 
     container_type const& beads() const noexcept {return beads_;}
-    container_type&       beads()       noexcept {return beads_;}
+    table_type     const& table() const noexcept {return table_;}
     std::string const&    name()  const noexcept {return name_;}
     std::string&          name()        noexcept {return name_;}
 
@@ -66,6 +73,7 @@ class CGChain
 
     std::string    name_;
     container_type beads_;
+    table_type     table_;
 };
 
 }//jarngreipr
@@ -0,0 +1,235 @@
+#ifndef JARNGREIPR_MODEL_CG_GROUP_CACHE_HPP
+#define JARNGREIPR_MODEL_CG_GROUP_CACHE_HPP
+#include <jarngreipr/model/CGGroup.hpp>
+#include <jarngreipr/model/CachedBead.hpp>
+#include <jarngreipr/util/mapped_file.hpp>
+#include <jarngreipr/util/log.hpp>
+#include <type_traits>
+#include <array>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+
+namespace jarngreipr
+{
+
+//
+// binary cache of a coarse-grained group.
+//
+// It stores the chains and their beads, except for the atoms and the
+// attributes. Attributes depend on the input file and are set after loading.
+// Bead indices are stored relative to the offset of the group, so a cached
+// group can be placed anywhere in a system. The file also stores `key`, a
+// hash of the inputs (structure, chains, model, masses), and a cache with a
+// different key is ignored.
+//
+// The format depends on the byte order and the size of real_type, which are
+// also checked on loading.
+//
+namespace detail
+{
+constexpr char          cg_group_cache_magic[8] = {'J','G','C','G','R','P','0','1'};
+constexpr std::uint32_t cg_group_cache_order    = 0x01020304;
+
+template<typename T>
+void write_binary(std::ostream& os, const T& value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "");
+    os.write(reinterpret_cast<const char*>(std::addressof(value)), sizeof(T));
+}
+inline void write_binary(std::ostream& os, const std::string& str)
+{
+    write_binary(os, static_cast<std::uint64_t>(str.size()));
+    os.write(str.data(), str.size());
+}
+
+// reads values from a memory region. it fails instead of reading out of range.
+class binary_cursor
+{
+  public:
+    binary_cursor(const char* first, const char* last) noexcept
+        : iter_(first), last_(last), ok_(true)
+    {}
+
+    template<typename T>
+    T read() noexcept
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "");
+        T value{};
+        if(!this->advance(sizeof(T))) {return value;}
+        std::memcpy(std::addressof(value), iter_ - sizeof(T), sizeof(T));
+        return value;
+    }
+    std::string read_string()
+    {
+        const std::uint64_t len = this->read<std::uint64_t>();
+        if(!this->advance(len)) {return std::string{};}
+        return std::string(iter_ - len, iter_);
+    }
+
+    bool ok()          const noexcept {return ok_;}
+    bool at_end()      const noexcept {return iter_ == last_;}
+    std::size_t left() const noexcept {return last_ - iter_;}
+
+  private:
+
+    bool advance(const std::uint64_t n) noexcept
+    {
+        if(!ok_ || static_cast<std::uint64_t>(last_ - iter_) < n)
+        {
+            ok_ = false;
+            return false;
+        }
+        iter_ += n;
+        return true;
+    }
+
+  private:
+    const char* iter_;
+    const char* last_;
+    bool        ok_;
+};
+} // detail
+
+template<typename realT>
+bool write_cg_group_cache(const std::string& fname, const std::uint64_t key,
+                          const CGGroup<realT>& group, const std::size_t offset)
+{
+    using detail::write_binary;
+
+    // write to a temporary file and rename it, not to leave a broken cache.
+    const std::string tmpname = fname + ".tmp";
+    {
+        std::ofstream ofs(tmpname, std::ios::binary);
+        if(!ofs.good())
+        {
+            log::warn("could not write a cache file: ", fname, '\n');
+            return false;
+        }
+        ofs.write(detail::cg_group_cache_magic, sizeof(detail::cg_group_cache_magic));
+        write_binary(ofs, detail::cg_group_cache_order);
+        write_binary(ofs, static_cast<std::uint32_t>(sizeof(realT)));
+        write_binary(ofs, key);
+        write_binary(ofs, static_cast<std::uint64_t>(group.size()));
+        for(const auto& chain : group)
+        {
+            write_binary(ofs, chain.name());
+            write_binary(ofs, static_cast<std::uint64_t>(chain.size()));
+            for(const auto& bead : chain)
+            {
+                const auto& heavy_positions = bead->heavy_positions();
+                const auto& heavy_classes   = bead->heavy_atom_classes();
+                const auto  position        = bead->position();
+
+                write_binary(ofs, static_cast<std::uint8_t>(bead->kind()));
+                write_binary(ofs, static_cast<std::uint64_t>(bead->index() - offset));
+                write_binary(ofs, bead->mass());
+                write_binary(ofs, bead->name());
+                for(std::size_t i=0; i<3; ++i) {write_binary(ofs, position[i]);}
+                write_binary(ofs, bead->residue_id());
+                write_binary(ofs, static_cast<std::uint64_t>(heavy_positions.size()));
+                for(const auto& pos : heavy_positions)
+                {
+                    for(std::size_t i=0; i<3; ++i) {write_binary(ofs, pos[i]);}
+                }
+                ofs.write(reinterpret_cast<const char*>(heavy_classes.data()),
+                          heavy_classes.size());
+            }
+        }
+        if(!ofs.good())
+        {
+            log::warn("could not write a cache file: ", fname, '\n');
+            std::remove(tmpname.c_str());
+            return false;
+        }
+    }
+    if(std::rename(tmpname.c_str(), fname.c_str()) != 0)
+    {
+        std::remove(tmpname.c_str());
+        return false;
+    }
+    return true;
+}
+
+// returns false if the file does not exist, has a different key, or is broken.
+template<typename realT>
+bool read_cg_group_cache(const std::string& fname, const std::uint64_t key,
+                         CGGroup<realT>& group, const std::size_t offset)
+{
+    using coordinate_type = typename CGBead<realT>::coordinate_type;
+    if(!std::ifstream(fname).good()) {return false;}
+
+    const mapped_file file(fname);
+    detail::binary_cursor cursor(file.begin(), file.end());
+
+    if(file.size() < sizeof(detail::cg_group_cache_magic) ||
+       std::memcmp(file.data(), detail::cg_group_cache_magic,
+                   sizeof(detail::cg_group_cache_magic)) != 0)
+    {
+        return false;
+    }
+    cursor.read<std::array<char, sizeof(detail::cg_group_cache_magic)>>();
+    if(cursor.read<std::uint32_t>() != detail::cg_group_cache_order ||
+       cursor.read<std::uint32_t>() != sizeof(realT) ||
+       cursor.read<std::uint64_t>() != key)
+    {
+        return false;
+    }
+
+    CGGroup<realT> loaded(group.name());
+    const std::uint64_t num_chains = cursor.read<std::uint64_t>();
+    for(std::uint64_t c=0; cursor.ok() && c<num_chains; ++c)
+    {
+        CGChain<realT> chain(cursor.read_string());
+        const std::uint64_t num_beads = cursor.read<std::uint64_t>();
+        for(std::uint64_t b=0; cursor.ok() && b<num_beads; ++b)
+        {
+            const auto kind_byte = cursor.read<std::uint8_t>();
+            if(kind_byte > static_cast<std::uint8_t>(CGBeadKind::ThreeSPN2Phosphate))
+            {
+                log::warn("cache file is broken: ", fname, '\n');
+                return false;
+            }
+            const auto kind  = static_cast<CGBeadKind>(kind_byte);
+            const auto index = cursor.read<std::uint64_t>() + offset;
+            const auto mass  = cursor.read<realT>();
+            auto       name  = cursor.read_string();
+            coordinate_type position;
+            for(std::size_t i=0; i<3; ++i) {position[i] = cursor.read<realT>();}
+            const auto resid = cursor.read<std::int32_t>();
+
+            // each heavy atom takes 3 reals and 1 byte. check it in advance
+            // not to allocate a huge buffer for a broken file.
+            const auto num_heavy = cursor.read<std::uint64_t>();
+            if(!cursor.ok() || cursor.left() / (3 * sizeof(realT) + 1) < num_heavy)
+            {
+                return false;
+            }
+            std::vector<coordinate_type> heavy_positions(num_heavy);
+            for(auto& pos : heavy_positions)
+            {
+                for(std::size_t i=0; i<3; ++i) {pos[i] = cursor.read<realT>();}
+            }
+            std::vector<std::uint8_t> heavy_classes(num_heavy);
+            for(auto& cls : heavy_classes)
+            {
+                cls = cursor.read<std::uint8_t>();
+            }
+            chain.push_back(std::make_shared<CachedBead<realT>>(kind, index,
+                mass, std::move(name), position, resid,
+                std::move(heavy_positions), std::move(heavy_classes)));
+        }
+        loaded.push_back(std::move(chain));
+    }
+    if(!cursor.ok() || !cursor.at_end())
+    {
+        log::warn("cache file is broken: ", fname, '\n');
+        return false;
+    }
+    group = std::move(loaded);
+    return true;
+}
+
+} // jarngreipr
+#endif// JARNGREIPR_MODEL_CG_GROUP_CACHE_HPP
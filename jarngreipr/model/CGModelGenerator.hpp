@@ -14,13 +14,15 @@ class CGModelGeneratorBase
     typedef realT real_type;
     typedef CGChain<real_type>  cg_chain_type;
     typedef PDBChain<real_type> pdb_chain_type;
+    typedef std::shared_ptr<const pdb_chain_type> pdb_chain_ptr;
 
   public:
 
     virtual ~CGModelGeneratorBase() = default;
 
+    // beads refer to the atoms in `pdb` without copying them.
     virtual cg_chain_type
-    generate(const pdb_chain_type& pdb, const std::size_t offset) const = 0;
+    generate(const pdb_chain_ptr& pdb, const std::size_t offset) const = 0;
 };
 
 // CGModelGenerator manages several subclasses of CGModelGeneratorBase.
@@ -34,6 +36,7 @@ class CGModelGenerator final
     typedef CGChain<real_type>              cg_chain_type;
     typedef PDBChain<real_type>             pdb_chain_type;
     typedef CGModelGeneratorBase<real_type> generator_base;
+    typedef typename generator_base::pdb_chain_ptr pdb_chain_ptr;
 
   public:
 
@@ -51,19 +54,19 @@ class CGModelGenerator final
     }
 
     std::vector<cg_chain_type>
-    generate(const std::vector<pdb_chain_type>& pdbs) const
+    generate(const std::vector<pdb_chain_ptr>& pdbs) const
     {
         std::vector<cg_chain_type> cg_chains;
 
         std::size_t offset = this->offset_;
         for(const auto& id_gen : this->generators_)
         {
-            const char  chain_id  = id_gen.first;
+            const auto& chain_id  = id_gen.first;
             const auto& generator = id_gen.second;
 
             const auto pdb_chain = std::find_if(pdbs.begin(), pdbs.end(),
-                [=](const pdb_chain_type& pdbchn) noexcept -> bool {
-                    return pdbchn.chain_id() == chain_id;
+                [&](const pdb_chain_ptr& pdbchn) noexcept -> bool {
+                    return pdbchn->chain_id() == chain_id;
                 });
             if(pdb_chain == pdbs.end())
             {
@@ -84,7 +87,7 @@ class CGModelGenerator final
     std::size_t offset_;
     std::vector<
         // pairof chain-ID & ModelGenerator
-        std::pair<char, std::shared_ptr<generator_base>>
+        std::pair<std::string, std::shared_ptr<generator_base>>
         > generators_;
 };
 
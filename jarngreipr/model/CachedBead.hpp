@@ -0,0 +1,47 @@
+#ifndef JARNGREIPR_MODEL_CACHED_BEAD_HPP
+#define JARNGREIPR_MODEL_CACHED_BEAD_HPP
+#include <jarngreipr/model/CGBead.hpp>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace jarngreipr
+{
+
+// a bead that has all the values used by ForceFieldGenerators, but not the
+// atoms. It is restored from a cache file, or made by transforming another
+// bead, e.g. a copy in a symmetric assembly.
+template<typename realT>
+class CachedBead final : public CGBead<realT>
+{
+  public:
+    typedef CGBead<realT> base_type;
+    typedef typename base_type::real_type       real_type;
+    typedef typename base_type::coordinate_type coordinate_type;
+
+  public:
+
+    CachedBead(CGBeadKind kind, std::size_t idx, real_type mass, std::string name,
+               coordinate_type position, std::int32_t residue_id,
+               std::vector<coordinate_type> heavy_positions,
+               std::vector<std::uint8_t>    heavy_atom_classes)
+        : base_type(kind, idx, mass, std::move(name), residue_id,
+                    std::move(heavy_positions), std::move(heavy_atom_classes)),
+          position_(position)
+    {}
+    ~CachedBead() override = default;
+
+    CachedBead(const CachedBead&) = default;
+    CachedBead(CachedBead&&)      = default;
+    CachedBead& operator=(const CachedBead&) = default;
+    CachedBead& operator=(CachedBead&&)      = default;
+
+    coordinate_type position() const override {return this->position_;}
+
+  private:
+
+    coordinate_type position_;
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_MODEL_CACHED_BEAD_HPP
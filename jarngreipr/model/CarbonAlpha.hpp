@@ -21,10 +21,12 @@ class CarbonAlpha final : public CGBead<realT>
     typedef typename base_type::atom_type       atom_type;
     typedef typename base_type::container_type  container_type;
 
+    static constexpr CGBeadKind bead_kind = CGBeadKind::CarbonAlpha;
+
   public:
 
     CarbonAlpha(std::size_t idx, real_type mass, container_type atoms, std::string name)
-        : base_type(idx, mass, std::move(atoms), std::move(name))
+        : base_type(bead_kind, idx, mass, std::move(atoms), std::move(name))
     {
         if(this->atoms_.empty())
         {
@@ -64,14 +66,14 @@ class CarbonAlpha final : public CGBead<realT>
     CarbonAlpha& operator=(const CarbonAlpha&) = default;
     CarbonAlpha& operator=(CarbonAlpha&&)      = default;
 
-    std::string kind() const override {return "CarbonAlpha";}
-
     coordinate_type position() const override {return this->position_;}
 
   private:
 
     coordinate_type position_;
 };
+template<typename realT>
+constexpr CGBeadKind CarbonAlpha<realT>::bead_kind;
 
 template<typename realT>
 class CarbonAlphaGenerator final : public CGModelGeneratorBase<realT>
@@ -81,6 +83,7 @@ class CarbonAlphaGenerator final : public CGModelGeneratorBase<realT>
     typedef typename base_type::real_type      real_type;
     typedef typename base_type::cg_chain_type  cg_chain_type;
     typedef typename base_type::pdb_chain_type pdb_chain_type;
+    typedef typename base_type::pdb_chain_ptr  pdb_chain_ptr;
 
   public:
 
@@ -88,15 +91,16 @@ class CarbonAlphaGenerator final : public CGModelGeneratorBase<realT>
     ~CarbonAlphaGenerator() override = default;
 
     cg_chain_type
-    generate(const pdb_chain_type& pdb, const std::size_t offset) const override
+    generate(const pdb_chain_ptr& pdb, const std::size_t offset) const override
     {
         const auto& mass_AICG2p = toml::find(this->masses_, "AICG2+");
 
-        CGChain<realT> retval(std::string(1, pdb.chain_id()));
-        for(std::size_t i=0; i<pdb.residues_size(); ++i)
+        CGChain<realT> retval(pdb->chain_id());
+        for(std::size_t i=0; i<pdb->residues_size(); ++i)
         {
-            const auto res = pdb.residue_at(i);
-            std::vector<PDBAtom<realT>> atoms(res.begin(), res.end());
+            // atoms in a residue are contiguous. refer them without copying.
+            const auto res = pdb->residue_at(i);
+            PDBAtomView<realT> atoms(pdb, pdb->residue_front_index(i), res.size());
             const auto name = atoms.front().residue_name;
             retval.push_back(std::make_shared<CarbonAlpha<realT>>(
                     i + offset, toml::find<real_type>(mass_AICG2p, name),
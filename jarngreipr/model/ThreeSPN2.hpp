@@ -20,11 +20,13 @@ class ThreeSPN2Base final : public CGBead<realT>
     typedef typename base_type::atom_type       atom_type;
     typedef typename base_type::container_type  container_type;
 
+    static constexpr CGBeadKind bead_kind = CGBeadKind::ThreeSPN2Base;
+
   public:
 
     ThreeSPN2Base(std::size_t idx, real_type mass, container_type atoms,
                   std::string name, coordinate_type center_of_mass)
-        : base_type(idx, mass, std::move(atoms), std::move(name)),
+        : base_type(bead_kind, idx, mass, std::move(atoms), std::move(name)),
           position_(center_of_mass)
     {}
     ~ThreeSPN2Base() override = default;
@@ -34,14 +36,14 @@ class ThreeSPN2Base final : public CGBead<realT>
     ThreeSPN2Base& operator=(const ThreeSPN2Base&) = default;
     ThreeSPN2Base& operator=(ThreeSPN2Base&&)      = default;
 
-    std::string kind() const override {return "3SPN2Base";}
-
     coordinate_type position() const override {return this->position_;}
 
   private:
 
     coordinate_type position_;
 };
+template<typename realT>
+constexpr CGBeadKind ThreeSPN2Base<realT>::bead_kind;
 
 template<typename realT>
 class ThreeSPN2Sugar final : public CGBead<realT>
@@ -53,11 +55,13 @@ class ThreeSPN2Sugar final : public CGBead<realT>
     typedef typename base_type::atom_type       atom_type;
     typedef typename base_type::container_type  container_type;
 
+    static constexpr CGBeadKind bead_kind = CGBeadKind::ThreeSPN2Sugar;
+
   public:
 
     ThreeSPN2Sugar(std::size_t idx, real_type mass, container_type atoms,
                    std::string name, coordinate_type center_of_mass)
-        : base_type(idx, mass, std::move(atoms), std::move(name)),
+        : base_type(bead_kind, idx, mass, std::move(atoms), std::move(name)),
           position_(center_of_mass)
     {}
     ~ThreeSPN2Sugar() override = default;
@@ -67,14 +71,14 @@ class ThreeSPN2Sugar final : public CGBead<realT>
     ThreeSPN2Sugar& operator=(const ThreeSPN2Sugar&) = default;
     ThreeSPN2Sugar& operator=(ThreeSPN2Sugar&&)      = default;
 
-    std::string kind() const override {return "3SPN2Sugar";}
-
     coordinate_type position() const override {return this->position_;}
 
   private:
 
     coordinate_type position_;
 };
+template<typename realT>
+constexpr CGBeadKind ThreeSPN2Sugar<realT>::bead_kind;
 
 template<typename realT>
 class ThreeSPN2Phosphate final : public CGBead<realT>
@@ -86,11 +90,13 @@ class ThreeSPN2Phosphate final : public CGBead<realT>
     typedef typename base_type::atom_type       atom_type;
     typedef typename base_type::container_type  container_type;
 
+    static constexpr CGBeadKind bead_kind = CGBeadKind::ThreeSPN2Phosphate;
+
   public:
 
     ThreeSPN2Phosphate(std::size_t idx, real_type mass, container_type atoms,
                        std::string name, coordinate_type center_of_mass)
-        : base_type(idx, mass, std::move(atoms), std::move(name)),
+        : base_type(bead_kind, idx, mass, std::move(atoms), std::move(name)),
           position_(center_of_mass)
     {}
     ~ThreeSPN2Phosphate() override = default;
@@ -100,14 +106,14 @@ class ThreeSPN2Phosphate final : public CGBead<realT>
     ThreeSPN2Phosphate& operator=(const ThreeSPN2Phosphate&) = default;
     ThreeSPN2Phosphate& operator=(ThreeSPN2Phosphate&&)      = default;
 
-    std::string kind() const override {return "3SPN2Phosphate";}
-
     coordinate_type position() const override {return this->position_;}
 
   private:
 
     coordinate_type position_;
 };
+template<typename realT>
+constexpr CGBeadKind ThreeSPN2Phosphate<realT>::bead_kind;
 
 template<typename realT>
 class ThreeSPN2Generator final : public CGModelGeneratorBase<realT>
@@ -117,6 +123,8 @@ class ThreeSPN2Generator final : public CGModelGeneratorBase<realT>
     using real_type        = typename base_type::real_type;
     using cg_chain_type    = typename base_type::cg_chain_type;
     using pdb_chain_type   = typename base_type::pdb_chain_type;
+    using pdb_chain_ptr    = typename base_type::pdb_chain_ptr;
+    using atom_view_type   = PDBAtomView<real_type>;
     using pdb_atom_type    = typename pdb_chain_type::atom_type;
     using pdb_residue_type = typename pdb_chain_type::const_residue_range;
     using coordinate_type  = typename pdb_atom_type::coordinate_type;
@@ -134,14 +142,15 @@ class ThreeSPN2Generator final : public CGModelGeneratorBase<realT>
     ~ThreeSPN2Generator() override = default;
 
     cg_chain_type
-    generate(const pdb_chain_type& pdb, const std::size_t offset) const override
+    generate(const pdb_chain_ptr& pdb_ptr, const std::size_t offset) const override
     {
-        cg_chain_type retval(std::string(1, pdb.chain_id()));
+        const auto& pdb = *pdb_ptr;
+        cg_chain_type retval(pdb.chain_id());
 
         std::string base_kind;
-        std::vector<PDBAtom<realT>> phosphate;
-        std::vector<PDBAtom<realT>> sugar;
-        std::vector<PDBAtom<realT>> base;
+        std::vector<std::size_t> phosphate_idxs;
+        std::vector<std::size_t> sugar_idxs;
+        std::vector<std::size_t> base_idxs;
 
         const auto& mass_3SPN2 = toml::find(this->masses_, "3SPN2");
 
@@ -150,7 +159,13 @@ class ThreeSPN2Generator final : public CGModelGeneratorBase<realT>
             const auto residue_id = pdb.residue_at(i).empty() ? 0 :
                                     pdb.residue_at(i).at(0).residue_id;
 
-            std::tie(base_kind, phosphate, sugar, base) = split_PSB(pdb, i);
+            std::tie(base_kind, phosphate_idxs, sugar_idxs, base_idxs) =
+                split_PSB(pdb, i);
+
+            // beads refer to the atoms in the chain without copying them
+            atom_view_type phosphate(pdb_ptr, std::move(phosphate_idxs));
+            atom_view_type sugar    (pdb_ptr, std::move(sugar_idxs));
+            atom_view_type base     (pdb_ptr, std::move(base_idxs));
             if(i != 0 && phosphate.size() != 5)
             {
                 log::error("3SPN2: invalid number of atoms in "
@@ -182,22 +197,23 @@ class ThreeSPN2Generator final : public CGModelGeneratorBase<realT>
             {
                 retval.push_back(std::make_shared<ThreeSPN2Phosphate<real_type>
                     >(3*i-1 + offset, toml::find<real_type>(mass_3SPN2, P_name),
-                      phosphate, P_name, P));
+                      std::move(phosphate), P_name, P));
             }
             retval.push_back(std::make_shared<ThreeSPN2Sugar<real_type>
                     >(3*i   + offset, toml::find<real_type>(mass_3SPN2, S_name),
-                      sugar, S_name, S));
+                      std::move(sugar), S_name, S));
             retval.push_back(std::make_shared<ThreeSPN2Base <real_type>
                     >(3*i+1 + offset, toml::find<real_type>(mass_3SPN2, B_name),
-                      base, B_name, B));
+                      std::move(base), B_name, B));
         }
         return retval;
     }
 
   private:
 
-    std::tuple<std::string, std::vector<pdb_atom_type>,
-               std::vector<pdb_atom_type>, std::vector<pdb_atom_type>>
+    // returns the base kind and the indices of atoms in phosphate, sugar, base
+    std::tuple<std::string, std::vector<std::size_t>,
+               std::vector<std::size_t>, std::vector<std::size_t>>
     split_PSB(const pdb_chain_type& pdb, const std::size_t i) const
     {
         //                          _
@@ -219,20 +235,22 @@ class ThreeSPN2Generator final : public CGModelGeneratorBase<realT>
         //                 \         |
         //                  O3'     _/
 
-        std::vector<pdb_atom_type> phosphate;
-        std::vector<pdb_atom_type> sugar;
-        std::vector<pdb_atom_type> base;
+        std::vector<std::size_t> phosphate;
+        std::vector<std::size_t> sugar;
+        std::vector<std::size_t> base;
 
         if(i != 0)
         {
             const auto resid_prev = pdb.residue_at(i).empty() ? 0 :
                                     pdb.residue_at(i).at(0).residue_id;
-            for(const auto& atom : pdb.residue_at(i-1))
+            const auto first = pdb.residue_front_index(i-1);
+            const auto last  = first + pdb.residue_at(i-1).size();
+            for(std::size_t idx=first; idx<last; ++idx)
             {
-                const auto name = remove_whitespaces(atom.atom_name);
+                const auto name = remove_whitespaces(pdb.atom_at(idx).atom_name);
                 if(name == "O3'" || name == "O3*")
                 {
-                    phosphate.push_back(atom);
+                    phosphate.push_back(idx);
                 }
             }
             if(phosphate.empty())
@@ -243,9 +261,12 @@ class ThreeSPN2Generator final : public CGModelGeneratorBase<realT>
             }
         }
 
-        for(const auto& atom : pdb.residue_at(i))
+        const auto first = pdb.residue_front_index(i);
+        const auto last  = first + pdb.residue_at(i).size();
+        for(std::size_t idx=first; idx<last; ++idx)
         {
-            const auto name = remove_whitespaces(atom.atom_name);
+            const auto& atom = pdb.atom_at(idx);
+            const auto  name = remove_whitespaces(atom.atom_name);
             if(atom_kind_.count(name) == 0)
             {
                 log::error("3SPN2: unrecognized DNA atom appeares\n");
@@ -260,18 +281,18 @@ class ThreeSPN2Generator final : public CGModelGeneratorBase<realT>
                     {
                         // skip O3' atom in the residue i.
                         // use O3' of i-1 th residue instead.
-                        phosphate.push_back(atom);
+                        phosphate.push_back(idx);
                     }
                     break;
                 }
                 case BeadKind::Sugar:
                 {
-                    sugar.push_back(atom);
+                    sugar.push_back(idx);
                     break;
                 }
                 case BeadKind::Base:
                 {
-                    base.push_back(atom);
+                    base.push_back(idx);
                     break;
                 }
             }
@@ -279,7 +300,7 @@ class ThreeSPN2Generator final : public CGModelGeneratorBase<realT>
 
         // assuming residue names are something like "DA"
         const auto base_kind =
-            this->remove_whitespaces(base.front().residue_name).substr(1, 1);
+            this->remove_whitespaces(pdb.atom_at(base.front()).residue_name).substr(1, 1);
 
         assert(base_kind == "A" || base_kind == "T" ||
                base_kind == "C" || base_kind == "G");
@@ -287,7 +308,7 @@ class ThreeSPN2Generator final : public CGModelGeneratorBase<realT>
         return std::make_tuple(base_kind, phosphate, sugar, base);
     }
 
-    coordinate_type calc_center_of_mass(const std::vector<pdb_atom_type>& atoms) const
+    coordinate_type calc_center_of_mass(const atom_view_type& atoms) const
     {
         coordinate_type com(0.0, 0.0, 0.0);
         real_type denom = 0.0;
@@ -0,0 +1,72 @@
+#ifndef JARNGREIPR_MODEL_EXPAND_ASSEMBLY_HPP
+#define JARNGREIPR_MODEL_EXPAND_ASSEMBLY_HPP
+#include <jarngreipr/geometry/SymmetryOperator.hpp>
+#include <jarngreipr/model/CachedBead.hpp>
+#include <jarngreipr/model/CGGroup.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace jarngreipr
+{
+
+// make copies of a coarse-grained asymmetric unit by symmetry operators,
+// without coarse-graining the copies again.
+//
+// The k-th copy (0-origin) is made by the k-th operator, and its chains are
+// named `<chain name>_<k+1>`. The index of a bead in the k-th copy is
+// `index + k * num_beads` where `num_beads` is the number of beads in the
+// unit, so the unit should have contiguous indices. Copies keep the kinds,
+// masses, names, residue IDs, and attributes of the beads, but not the atoms.
+// If an operator is the identity, the beads of the unit are shared.
+template<typename realT>
+CGGroup<realT> expand_assembly(const CGGroup<realT>& unit,
+                               const std::vector<SymmetryOperator<realT>>& ops)
+{
+    using bead_type       = CachedBead<realT>;
+    using coordinate_type = typename bead_type::coordinate_type;
+
+    std::size_t num_beads = 0;
+    for(const auto& chain : unit)
+    {
+        num_beads += chain.size();
+    }
+
+    CGGroup<realT> assembly(unit.name());
+    for(std::size_t k=0; k<ops.size(); ++k)
+    {
+        const auto& op = ops.at(k);
+        for(const auto& chain : unit)
+        {
+            CGChain<realT> copy(chain.name() + "_" + std::to_string(k+1));
+            for(const auto& bead : chain)
+            {
+                if(k == 0 && op.is_identity())
+                {
+                    copy.push_back(bead);
+                    continue;
+                }
+                std::vector<coordinate_type> heavy_positions;
+                heavy_positions.reserve(bead->heavy_positions().size());
+                for(const auto& pos : bead->heavy_positions())
+                {
+                    heavy_positions.push_back(op.apply(pos));
+                }
+                auto transformed = std::make_shared<bead_type>(bead->kind(),
+                    bead->index() + k * num_beads, bead->mass(), bead->name(),
+                    op.apply(bead->position()), bead->residue_id(),
+                    std::move(heavy_positions), bead->heavy_atom_classes());
+                for(const auto& attr : bead->attributes())
+                {
+                    transformed->attribute(attr.first) = attr.second;
+                }
+                copy.push_back(std::move(transformed));
+            }
+            assembly.push_back(std::move(copy));
+        }
+    }
+    return assembly;
+}
+
+} // jarngreipr
+#endif// JARNGREIPR_MODEL_EXPAND_ASSEMBLY_HPP
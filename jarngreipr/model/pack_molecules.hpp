@@ -0,0 +1,125 @@
+#ifndef JARNGREIPR_MODEL_PACK_MOLECULES_HPP
+#define JARNGREIPR_MODEL_PACK_MOLECULES_HPP
+#include <jarngreipr/geometry/PeriodicCellList.hpp>
+#include <jarngreipr/geometry/SymmetryOperator.hpp>
+#include <jarngreipr/model/CGGroup.hpp>
+#include <jarngreipr/util/log.hpp>
+#include <random>
+#include <vector>
+#include <cmath>
+
+namespace jarngreipr
+{
+
+// place `num_copies` copies of a coarse-grained unit in a periodic box with
+// random orientations and positions. The result can be passed to
+// expand_assembly.
+//
+// A copy is rejected and tried again if any of its beads is closer than
+// `min_distance` to a bead of the copies already placed, taking the periodic
+// boundary into account. Overlaps within a copy are not checked. If a copy
+// cannot be placed in `max_trials` trials, the box is regarded as too crowded.
+template<typename realT, typename RNG>
+std::vector<SymmetryOperator<realT>>
+pack_molecules(const CGGroup<realT>& unit, const std::size_t num_copies,
+               const mjolnir::math::Vector<realT, 3>& lower,
+               const mjolnir::math::Vector<realT, 3>& upper,
+               const realT min_distance, RNG& rng,
+               const std::size_t max_trials = 1000)
+{
+    using coordinate_type = mjolnir::math::Vector<realT, 3>;
+    using operator_type   = SymmetryOperator<realT>;
+    constexpr realT pi = 3.141592653589793;
+
+    // rotate the unit around its center of geometry.
+    std::vector<coordinate_type> positions;
+    coordinate_type center(0.0, 0.0, 0.0);
+    for(const auto& chain : unit)
+    {
+        for(const auto& bead : chain)
+        {
+            positions.push_back(bead->position());
+            center += bead->position();
+        }
+    }
+    if(positions.empty())
+    {
+        log::error("pack_molecules: group ", unit.name(), " has no bead\n");
+        std::terminate();
+    }
+    center /= static_cast<realT>(positions.size());
+    for(auto& pos : positions)
+    {
+        pos -= center;
+    }
+
+    PeriodicCellList<realT> cell_list(lower, upper, min_distance,
+                                      positions.size() * num_copies);
+    std::uniform_real_distribution<realT> uni(0.0, 1.0);
+
+    std::vector<operator_type> ops;
+    ops.reserve(num_copies);
+    std::vector<coordinate_type> moved(positions.size());
+    for(std::size_t copy=0; copy<num_copies; ++copy)
+    {
+        bool placed = false;
+        for(std::size_t trial=0; trial<max_trials && !placed; ++trial)
+        {
+            // uniform random rotation from a unit quaternion (Shoemake, 1992)
+            const realT u1 = uni(rng), u2 = uni(rng), u3 = uni(rng);
+            const realT w = std::sqrt(1.0 - u1) * std::sin(2 * pi * u2);
+            const realT x = std::sqrt(1.0 - u1) * std::cos(2 * pi * u2);
+            const realT y = std::sqrt(u1)       * std::sin(2 * pi * u3);
+            const realT z = std::sqrt(u1)       * std::cos(2 * pi * u3);
+
+            operator_type op;
+            op.rotation = {{
+                {{1 - 2*(y*y + z*z),     2*(x*y - z*w),     2*(x*z + y*w)}},
+                {{    2*(x*y + z*w), 1 - 2*(x*x + z*z),     2*(y*z - x*w)}},
+                {{    2*(x*z - y*w),     2*(y*z + x*w), 1 - 2*(x*x + y*y)}}
+            }};
+            for(std::size_t i=0; i<3; ++i)
+            {
+                op.translation[i] = lower[i] + (upper[i] - lower[i]) * uni(rng);
+            }
+
+            placed = true;
+            for(std::size_t i=0; i<positions.size(); ++i)
+            {
+                moved[i] = op.apply(positions[i]);
+                if(cell_list.any_within(moved[i]))
+                {
+                    placed = false;
+                    break;
+                }
+            }
+            if(!placed) {continue;}
+
+            for(const auto& pos : moved)
+            {
+                cell_list.insert(pos);
+            }
+            // positions were centered. x' = R (x - c) + t = R x + (t - R c)
+            const auto rotated_center = op.apply(center) -
+                coordinate_type(op.translation[0], op.translation[1], op.translation[2]);
+            for(std::size_t i=0; i<3; ++i)
+            {
+                op.translation[i] -= rotated_center[i];
+            }
+            ops.push_back(op);
+        }
+        if(!placed)
+        {
+            log::error("pack_molecules: could not place copy ", copy + 1, " of ",
+                       num_copies, " of group ", unit.name(), " in ", max_trials,
+                       " trials. The box may be too small.\n");
+            std::terminate();
+        }
+    }
+    log::info("pack_molecules: placed ", num_copies, " copies of group ",
+              unit.name(), '\n');
+    return ops;
+}
+
+} // jarngreipr
+#endif// JARNGREIPR_MODEL_PACK_MOLECULES_HPP
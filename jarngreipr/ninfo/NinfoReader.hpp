@@ -3,7 +3,7 @@
 #include <jarngreipr/ninfo/NinfoData.hpp>
 #include <jarngreipr/util/read_number.hpp>
 #include <jarngreipr/util/log.hpp>
-#include <fstream>
+#include <jarngreipr/util/gzip.hpp>
 
 namespace jarngreipr
 {
@@ -127,7 +127,7 @@ class NinfoReader
 
     std::size_t line_num_;
     std::string filename_;
-    std::ifstream ifstrm_;
+    igzstream   ifstrm_; // also reads .gz files
     data_type       data_; // store blocks that have already been read
 };
 
@@ -19,7 +19,7 @@ struct PDBAtom
 
     char         altloc;
     char         icode;
-    char         chain_id;
+    std::string  chain_id; // 1 letter in pdb files, may be longer in mmCIF
     std::int32_t atom_id;
     std::int32_t residue_id;
     real_type    occupancy;
@@ -42,7 +42,8 @@ std::basic_ostream<charT, traits>& operator<<(
     os << atm.altloc;
     os << std::left  << std::setw(3) << atm.residue_name;
     os << ' ';
-    os << atm.chain_id;
+    // the pdb format has only one column for chain ID
+    os << (atm.chain_id.empty() ? ' ' : atm.chain_id.front());
     os << std::right << std::setw(4) << atm.residue_id;
     os << atm.icode;
     os << "   ";
@@ -0,0 +1,129 @@
+#ifndef JARNGREIPR_PDB_ATOM_VIEW_HPP
+#define JARNGREIPR_PDB_ATOM_VIEW_HPP
+#include <jarngreipr/pdb/PDBChain.hpp>
+#include <stdexcept>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace jarngreipr
+{
+
+//
+// A read-only list of atoms in a PDBChain, referred by their indices.
+//
+// It does not copy the atoms. It shares the ownership of the chain, so the
+// chain lives as long as a view refers to it. Atoms in a residue are stored
+// contiguously, so a view of a residue only keeps the first index and the
+// size. Otherwise (e.g. a 3SPN2 phosphate that contains O3' of the previous
+// residue), it keeps a list of indices.
+//
+template<typename realT>
+class PDBAtomView
+{
+  public:
+    using real_type  = realT;
+    using atom_type  = PDBAtom<real_type>;
+    using chain_type = PDBChain<real_type>;
+    using chain_ptr  = std::shared_ptr<const chain_type>;
+
+    class const_iterator
+    {
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = atom_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = atom_type const*;
+        using reference         = atom_type const&;
+
+        const_iterator() noexcept: view_(nullptr), idx_(0) {}
+        const_iterator(const PDBAtomView* v, const std::size_t i) noexcept
+            : view_(v), idx_(i)
+        {}
+
+        reference operator*()  const {return (*view_)[idx_];}
+        pointer   operator->() const {return std::addressof((*view_)[idx_]);}
+        reference operator[](const difference_type n) const {return (*view_)[idx_ + n];}
+
+        const_iterator& operator++()    noexcept {++idx_; return *this;}
+        const_iterator& operator--()    noexcept {--idx_; return *this;}
+        const_iterator  operator++(int) noexcept {auto t(*this); ++idx_; return t;}
+        const_iterator  operator--(int) noexcept {auto t(*this); --idx_; return t;}
+        const_iterator& operator+=(const difference_type n) noexcept {idx_ += n; return *this;}
+        const_iterator& operator-=(const difference_type n) noexcept {idx_ -= n; return *this;}
+        const_iterator  operator+ (const difference_type n) const noexcept {return const_iterator(view_, idx_ + n);}
+        const_iterator  operator- (const difference_type n) const noexcept {return const_iterator(view_, idx_ - n);}
+        difference_type operator- (const const_iterator& rhs) const noexcept
+        {
+            return static_cast<difference_type>(idx_) -
+                   static_cast<difference_type>(rhs.idx_);
+        }
+
+        bool operator==(const const_iterator& rhs) const noexcept {return idx_ == rhs.idx_;}
+        bool operator!=(const const_iterator& rhs) const noexcept {return idx_ != rhs.idx_;}
+        bool operator< (const const_iterator& rhs) const noexcept {return idx_ <  rhs.idx_;}
+        bool operator> (const const_iterator& rhs) const noexcept {return idx_ >  rhs.idx_;}
+        bool operator<=(const const_iterator& rhs) const noexcept {return idx_ <= rhs.idx_;}
+        bool operator>=(const const_iterator& rhs) const noexcept {return idx_ >= rhs.idx_;}
+
+      private:
+        const PDBAtomView* view_;
+        std::size_t        idx_;
+    };
+    using iterator = const_iterator;
+
+  public:
+
+    PDBAtomView(): first_(0), size_(0) {}
+
+    // atoms in [first, first + size)
+    PDBAtomView(chain_ptr chain, const std::size_t first, const std::size_t size)
+        : chain_(std::move(chain)), first_(first), size_(size)
+    {}
+    // atoms at the indices
+    PDBAtomView(chain_ptr chain, std::vector<std::size_t> indices)
+        : chain_(std::move(chain)), first_(0), size_(indices.size()),
+          indices_(std::move(indices))
+    {}
+    ~PDBAtomView() = default;
+    PDBAtomView(const PDBAtomView&) = default;
+    PDBAtomView(PDBAtomView&&)      = default;
+    PDBAtomView& operator=(const PDBAtomView&) = default;
+    PDBAtomView& operator=(PDBAtomView&&)      = default;
+
+    bool       empty() const noexcept {return size_ == 0;}
+    std::size_t size() const noexcept {return size_;}
+
+    atom_type const& operator[](const std::size_t i) const noexcept
+    {
+        return chain_->atom_at(indices_.empty() ? first_ + i : indices_[i]);
+    }
+    atom_type const& at(const std::size_t i) const
+    {
+        if(size_ <= i)
+        {
+            throw std::out_of_range("PDBAtomView::at: index out of range");
+        }
+        return (*this)[i];
+    }
+
+    atom_type const& front() const noexcept {return (*this)[0];}
+    atom_type const& back()  const noexcept {return (*this)[size_ - 1];}
+
+    const_iterator begin()  const noexcept {return const_iterator(this, 0);}
+    const_iterator end()    const noexcept {return const_iterator(this, size_);}
+    const_iterator cbegin() const noexcept {return const_iterator(this, 0);}
+    const_iterator cend()   const noexcept {return const_iterator(this, size_);}
+
+    chain_ptr const& chain() const noexcept {return chain_;}
+
+  private:
+
+    chain_ptr                chain_;
+    std::size_t              first_;
+    std::size_t              size_;
+    std::vector<std::size_t> indices_; // empty if contiguous
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_PDB_ATOM_VIEW_HPP
@@ -2,6 +2,7 @@
 #define JARNGREIPR_IO_PDB_CHAIN
 #include <jarngreipr/pdb/PDBAtom.hpp>
 #include <mjolnir/util/range.hpp>
+#include <iterator>
 #include <vector>
 
 namespace jarngreipr
@@ -25,27 +26,26 @@ class PDBChain
 
     explicit PDBChain(std::vector<atom_type> atoms): atoms_(std::move(atoms))
     {
-        std::int32_t residue_id = this->atoms_.front().residue_id;
-        const_iterator    first = this->atoms_.begin();
-        for(auto i = this->atoms_.begin(), e = this->atoms_.end(); i!=e; ++i)
-        {
-            if(i->residue_id != residue_id)
-            {
-                this->residues_.push_back(const_residue_range(first, i));
-                first = i;
-                residue_id = i->residue_id;
-            }
-        }
-        this->residues_.push_back(const_residue_range(first, this->atoms_.end()));
+        this->make_residues();
     }
 
     ~PDBChain() = default;
-    PDBChain(const PDBChain&) = default;
-    PDBChain(PDBChain&&)      = default;
-    PDBChain& operator=(const PDBChain&) = default;
-    PDBChain& operator=(PDBChain&&)      = default;
+    PDBChain(PDBChain&&)            = default;
+    PDBChain& operator=(PDBChain&&) = default;
+
+    // residue ranges point to the atoms, so they should be re-constructed.
+    PDBChain(const PDBChain& other): atoms_(other.atoms_)
+    {
+        this->make_residues();
+    }
+    PDBChain& operator=(const PDBChain& other)
+    {
+        this->atoms_ = other.atoms_;
+        this->make_residues();
+        return *this;
+    }
 
-    char chain_id() const noexcept {return this->atoms_.front().chain_id;}
+    std::string const& chain_id() const noexcept {return this->atoms_.front().chain_id;}
 
     bool empty() const noexcept {return atoms_.empty();}
     void clear()                {return atoms_.clear();}
@@ -56,7 +56,13 @@ class PDBChain
     std::size_t residues_size() const noexcept {return residues_.size();}
 
     const_residue_range residue_at(const std::size_t i) const {return residues_.at(i);}
-    const_residue_range atom_at   (const std::size_t i) const {return atoms_.at(i);}
+    atom_type const&    atom_at   (const std::size_t i) const noexcept {return atoms_[i];}
+
+    // the index of the first atom in the i-th residue.
+    std::size_t residue_front_index(const std::size_t i) const
+    {
+        return std::distance(atoms_.cbegin(), residues_.at(i).begin());
+    }
 
     const_iterator begin()  const noexcept {return atoms_.begin();}
     const_iterator end()    const noexcept {return atoms_.end();}
@@ -68,6 +74,28 @@ class PDBChain
     const_residue_iterator res_cbegin() const noexcept {return residues_.cbegin();}
     const_residue_iterator res_cend()   const noexcept {return residues_.cend();}
 
+  private:
+
+    void make_residues()
+    {
+        this->residues_.clear();
+        if(this->atoms_.empty()) {return;}
+
+        std::int32_t residue_id = this->atoms_.front().residue_id;
+        const_iterator    first = this->atoms_.cbegin();
+        for(auto i = this->atoms_.cbegin(), e = this->atoms_.cend(); i!=e; ++i)
+        {
+            if(i->residue_id != residue_id)
+            {
+                this->residues_.push_back(const_residue_range(first, i));
+                first = i;
+                residue_id = i->residue_id;
+            }
+        }
+        this->residues_.push_back(const_residue_range(first, this->atoms_.cend()));
+        return;
+    }
+
   private:
 
     std::vector<const_residue_range> residues_;
@@ -0,0 +1,128 @@
+#ifndef JARNGREIPR_PDB_CHAIN_INDEX_HPP
+#define JARNGREIPR_PDB_CHAIN_INDEX_HPP
+#include <jarngreipr/util/parse_number.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <map>
+#include <cstring>
+#include <cstdint>
+
+namespace jarngreipr
+{
+
+// a block of ATOM records that forms a chain.
+struct PDBChainRecord
+{
+    char         chain_id; // chain ID of the first ATOM record
+    std::int32_t model;    // serial number of the MODEL. 1 if no MODEL record.
+    std::size_t  first;    // byte offset of the first ATOM record
+    std::size_t  last;     // byte offset next to the last ATOM record
+    std::size_t  line;     // line number of the first ATOM record
+};
+
+// locations of chains in a pdb file. It only looks at the record names and
+// the chain IDs, so it is much faster than parsing all the atoms. A reader can
+// seek to a chain and parse only the chains that are actually used.
+//
+// A chain is a contiguous block of ATOM records terminated by TER, ENDMDL, or
+// the end of the file, as PDBReader does.
+class PDBChainIndex
+{
+  public:
+    using record_type = PDBChainRecord;
+    using key_type    = std::pair<std::int32_t, char>; // {model, chain ID}
+
+  public:
+
+    PDBChainIndex(const char* const first, const char* const last)
+    {
+        std::int32_t model      = 1;
+        bool         in_chain   = false;
+        std::size_t  line_num   = 0;
+        record_type  current{' ', model, 0, 0, 0};
+
+        const char* iter = first;
+        while(iter != last)
+        {
+            const char* const eol = std::find(iter, last, '\n');
+            const std::size_t len = eol - iter;
+            const char* const next = (eol == last) ? last : eol + 1;
+            line_num += 1;
+
+            if(starts_with(iter, len, "ATOM  "))
+            {
+                if(!in_chain)
+                {
+                    in_chain         = true;
+                    current.chain_id = (21 < len) ? iter[21] : ' ';
+                    current.model    = model;
+                    current.first    = iter - first;
+                    current.line     = line_num;
+                }
+                current.last = next - first;
+            }
+            else if(starts_with(iter, len, "TER") ||
+                    starts_with(iter, len, "ENDMDL"))
+            {
+                if(in_chain) {this->add(current);}
+                in_chain = false;
+            }
+            else if(starts_with(iter, len, "MODEL "))
+            {
+                std::int32_t serial = 0;
+                model = parse_integer(iter + 6, eol, serial) ? serial : model + 1;
+            }
+            iter = next;
+        }
+        if(in_chain) {this->add(current);}
+    }
+
+    // in the order of appearance in the file.
+    std::vector<record_type>  const& records() const noexcept {return records_;}
+    std::vector<std::int32_t> const& models()  const noexcept {return models_;}
+
+    // returns nullptr if not found.
+    record_type const* find(const char chain_id, const std::int32_t model) const
+    {
+        const auto found = this->by_key_.find(key_type(model, chain_id));
+        return (found == by_key_.end()) ? nullptr : &records_[found->second];
+    }
+    // the first chain that has the ID, regardless of its model.
+    record_type const* find(const char chain_id) const
+    {
+        const auto found = this->by_id_.find(chain_id);
+        return (found == by_id_.end()) ? nullptr : &records_[found->second];
+    }
+
+  private:
+
+    static bool starts_with(const char* line, const std::size_t len,
+                            const char* prefix) noexcept
+    {
+        const std::size_t n = std::strlen(prefix);
+        return n <= len && std::equal(prefix, prefix + n, line);
+    }
+
+    void add(const record_type& rec)
+    {
+        // if the same ID appears twice, the first one is used.
+        this->by_key_.emplace(key_type(rec.model, rec.chain_id), records_.size());
+        this->by_id_ .emplace(rec.chain_id, records_.size());
+        this->records_.push_back(rec);
+        if(std::find(models_.begin(), models_.end(), rec.model) == models_.end())
+        {
+            this->models_.push_back(rec.model);
+        }
+    }
+
+  private:
+
+    std::vector<record_type>        records_;
+    std::vector<std::int32_t>       models_;
+    std::map<key_type, std::size_t> by_key_;
+    std::map<char,     std::size_t> by_id_;
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_PDB_CHAIN_INDEX_HPP
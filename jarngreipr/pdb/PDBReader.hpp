@@ -2,97 +2,370 @@
 #define JARNGREIPR_PDB_READER_HPP
 #include <jarngreipr/pdb/PDBAtom.hpp>
 #include <jarngreipr/pdb/PDBChain.hpp>
-#include <jarngreipr/util/read_number.hpp>
-#include <fstream>
-#include <sstream>
+#include <jarngreipr/pdb/PDBChainIndex.hpp>
+#include <jarngreipr/pdb/StructureReaderBase.hpp>
+#include <jarngreipr/util/mapped_file.hpp>
+#include <jarngreipr/util/parse_number.hpp>
+#include <jarngreipr/util/source_location.hpp>
+#include <jarngreipr/util/log.hpp>
+#include <jarngreipr/util/parallel_for.hpp>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <map>
 
 namespace jarngreipr
 {
 
-// lazy pdb reader. assuming there are only one model.
+// lazy pdb reader.
+//
+// The file is mapped onto the memory and each record is read as a range of
+// characters in it. Fixed-width columns are parsed directly from the range,
+// and a source_location is constructed only when an error is reported.
+//
+// On construction, it scans the record names to find where the chains are.
+// read_chain parses only the requested chain. If more than one thread is
+// given, a large chain is split into chunks at line boundaries and the chunks
+// are parsed concurrently. The result is the same as the serial one.
 template<typename realT>
-class PDBReader
+class PDBReader final : public StructureReaderBase<realT>
 {
   public:
-    using real_type  = realT;
-    using atom_type  = PDBAtom<real_type>;
-    using chain_type = PDBChain<real_type>;
+    using base_type     = StructureReaderBase<realT>;
+    using real_type     = typename base_type::real_type;
+    using chain_type    = typename base_type::chain_type;
+    using chain_ptr     = typename base_type::chain_ptr;
+    using atom_type     = PDBAtom<real_type>;
+    using operator_type = typename base_type::operator_type;
 
   public:
 
-    explicit PDBReader(const std::string& fname)
-        : line_num_(0), filename_(fname), ifstrm_(fname)
+    explicit PDBReader(const std::string& fname, const std::size_t num_threads = 1)
+        : base_type(num_threads),
+          filename_(fname), file_(fname), index_(file_.begin(), file_.end())
+    {}
+    ~PDBReader() override = default;
+
+    PDBChainIndex const& index() const noexcept {return index_;}
+
+    // chain IDs in pdb files are 1 letter.
+    chain_ptr read_chain(const std::string& id) override
+    {
+        if(id.size() != 1)
+        {
+            log::error("PDBReader: chain ID should be 1 letter -> ", id, '\n');
+            std::terminate();
+        }
+        return this->read_chain(id.front());
+    }
+    chain_ptr read_chain(const std::string& id, const std::int32_t model) override
     {
-        if(!ifstrm_.good())
+        if(id.size() != 1)
         {
-            log::error("PDBReader: file open error: ", filename_, '\n');
+            log::error("PDBReader: chain ID should be 1 letter -> ", id, '\n');
             std::terminate();
         }
+        return this->read_chain(id.front(), model);
     }
 
-    bool is_eof() {this->ifstrm_.peek(); return this->ifstrm_.eof();}
-    void rewind() {this->ifstrm_.seekg(0, std::ios::beg);}
+    std::vector<std::int32_t> models() const override {return index_.models();}
 
-    chain_type const& read_chain(const char id)
+    // BIOMT records in REMARK 350. The operators of the biomolecule are
+    // returned in the order of their serial numbers. Since REMARKs precede
+    // the coordinates, it stops at the first ATOM or MODEL record.
+    //
+    // A biomolecule may apply different sets of operators to different
+    // chains ("APPLY THE FOLLOWING TO CHAINS: A, B"). All the `chains` should
+    // belong to the same set, otherwise the assembly cannot be built by
+    // applying one list of operators to the whole group.
+    std::vector<operator_type> biomt(const std::int32_t biomolecule,
+            const std::vector<std::string>& chains) const override
     {
-        const auto found = std::find_if(chains_.begin(), chains_.end(),
-            [id](const chain_type& ch) noexcept -> bool {
-                return ch.chain_id() == id;
-            });
-        if(found != this->chains_.end())
+        // {chains, operators} for each "APPLY THE FOLLOWING TO CHAINS"
+        std::vector<std::pair<std::vector<std::string>,
+                              std::vector<operator_type>>> sets;
+        std::int32_t current = 0;
+        std::size_t  line_num = 0;
+        const char* iter = this->file_.begin();
+        const char* last = this->file_.end();
+        while(iter != last)
         {
-            return *found;
+            const char* eol = std::find(iter, last, '\n');
+            const line_view line{iter, static_cast<std::size_t>(eol - iter), ++line_num};
+            iter = (eol == last) ? last : eol + 1;
+
+            if(line.starts_with("ATOM  ", 6) || line.starts_with("MODEL ", 6))
+            {
+                break;
+            }
+            if(!line.starts_with("REMARK 350", 10)) {continue;}
+
+            if(line.size >= 23 && std::equal(line.data + 11, line.data + 23,
+                                             "BIOMOLECULE:"))
+            {
+                if(!parse_integer(line.data + 23, line.data + line.size, current))
+                {
+                    log::error("PDBReader: invalid biomolecule number",
+                               this->location(line, 23, line.size - 23), "here");
+                    std::terminate();
+                }
+                continue;
+            }
+            if(current != biomolecule) {continue;}
+
+            // "APPLY THE FOLLOWING TO CHAINS: A, B," may continue to the next
+            // lines as "AND CHAINS: C, D".
+            const char* const chains_label = "CHAINS:";
+            const char* label = std::search(line.data + 11, line.data + line.size,
+                                            chains_label, chains_label + 7);
+            if(label != line.data + line.size)
+            {
+                const std::string head(line.data + 11, label);
+                if(head.find("APPLY THE FOLLOWING TO") != std::string::npos)
+                {
+                    sets.emplace_back();
+                }
+                else if(head.find("AND") == std::string::npos || sets.empty() ||
+                        !sets.back().second.empty())
+                {
+                    log::error("PDBReader: unexpected chain list in REMARK 350",
+                        this->location(line, 11, label + 7 - line.data - 11), "here");
+                    std::terminate();
+                }
+                auto& ids = sets.back().first;
+                std::string id;
+                for(const char* c = label + 7; c != line.data + line.size + 1; ++c)
+                {
+                    if(c == line.data + line.size || *c == ',' || *c == ' ')
+                    {
+                        if(!id.empty()) {ids.push_back(id);}
+                        id.clear();
+                    }
+                    else
+                    {
+                        id += *c;
+                    }
+                }
+                continue;
+            }
+
+            if(line.size < 19 || !std::equal(line.data + 13, line.data + 18, "BIOMT"))
+            {
+                continue;
+            }
+
+            // BIOMT1, BIOMT2, and BIOMT3 are the rows of an operator.
+            const char row = get_char_at(line, 18);
+            if(row < '1' || '3' < row)
+            {
+                log::error("PDBReader: invalid BIOMT record",
+                           this->location(line, 13, 6), "here");
+                std::terminate();
+            }
+            if(sets.empty())
+            {
+                // old files may lack the chain list. apply it to all chains.
+                log::warn("PDBReader: BIOMT records of biomolecule ", biomolecule,
+                          " do not have a chain list. It is applied to all the "
+                          "chains.\n");
+                sets.emplace_back();
+            }
+            auto& ops = sets.back().second;
+            const std::size_t r = row - '1';
+            if(r == 0) {ops.push_back(operator_type::identity());}
+            else if(ops.empty())
+            {
+                log::error("PDBReader: BIOMT", row, " appears before BIOMT1",
+                           this->location(line, 13, 6), "here");
+                std::terminate();
+            }
+            auto& op = ops.back();
+            op.rotation[r][0] = read_number<real_type>(line, 23, 10);
+            op.rotation[r][1] = read_number<real_type>(line, 33, 10);
+            op.rotation[r][2] = read_number<real_type>(line, 43, 10);
+            op.translation[r] = read_number<real_type>(line, 53, 15);
+        }
+        if(sets.empty())
+        {
+            log::error("PDBReader: file \"", filename_, "\" does not have "
+                       "BIOMT records of biomolecule ", biomolecule, ".\n");
+            std::terminate();
         }
 
-        while(!this->ifstrm_.eof())
+        // find the set that contains the chains. an empty list means all.
+        const auto contains = [](const std::vector<std::string>& ids,
+                                 const std::string& id) -> bool {
+            return ids.empty() || std::find(ids.begin(), ids.end(), id) != ids.end();
+        };
+        const auto found = std::find_if(sets.begin(), sets.end(),
+            [&](const std::pair<std::vector<std::string>,
+                                std::vector<operator_type>>& set) -> bool {
+                return std::all_of(chains.begin(), chains.end(),
+                    [&](const std::string& id) {return contains(set.first, id);});
+            });
+        if(found == sets.end())
         {
-            this->chains_.push_back(this->read_next_chain());
-            if(this->chains_.back().chain_id() == id)
+            log::error("PDBReader: BIOMT records of biomolecule ", biomolecule,
+                       " in file \"", filename_, "\" apply different operators "
+                       "to the chains in the group or do not apply to some of them."
+                       " Define groups for each chain list of REMARK 350.\n");
+            std::terminate();
+        }
+        for(const auto& id : found->first)
+        {
+            if(std::find(chains.begin(), chains.end(), id) == chains.end())
             {
-                return this->chains_.back();
+                log::warn("PDBReader: biomolecule ", biomolecule, " contains chain ",
+                          id, " that is not in the group. It is not expanded.\n");
             }
         }
+        if(found->second.empty())
+        {
+            log::error("PDBReader: file \"", filename_, "\" does not have "
+                       "BIOMT records of biomolecule ", biomolecule, ".\n");
+            std::terminate();
+        }
+        return found->second;
+    }
 
-        log::error("PDBReader: file \"", filename_, "\" does not "
-                              "contain chain ", id, ".\n");
-        std::terminate();
+    chain_ptr read_chain(const char id)
+    {
+        const auto rec = this->index_.find(id);
+        if(!rec)
+        {
+            log::error("PDBReader: file \"", filename_, "\" does not "
+                                  "contain chain ", id, ".\n");
+            std::terminate();
+        }
+        return this->read_chain(*rec);
+    }
+    chain_ptr read_chain(const char id, const std::int32_t model)
+    {
+        const auto rec = this->index_.find(id, model);
+        if(!rec)
+        {
+            log::error("PDBReader: file \"", filename_, "\" does not "
+                       "contain chain ", id, " in model ", model, ".\n");
+            std::terminate();
+        }
+        return this->read_chain(*rec);
     }
 
   private:
 
-    // lazy functions.
-    atom_type read_atom(const std::string& line)
+    // a line in the file, without the trailing newline.
+    struct line_view
     {
-        source_location src(this->filename_, line, 0, 6, this->line_num_);
-        if(get_substr(src, 0, 6) != "ATOM  ")
+        const char* data;
+        std::size_t size;
+        std::size_t line_num;
+
+        bool starts_with(const char* prefix, const std::size_t len) const noexcept
         {
-            log::error("internal error: not an ATOM line\n", src,
-                                  "prefix is not \"ATOM\"\n");
+            return len <= size && std::equal(prefix, prefix + len, data);
+        }
+    };
+
+    chain_ptr read_chain(const PDBChainRecord& rec)
+    {
+        const auto key = PDBChainIndex::key_type(rec.model, rec.chain_id);
+        const auto found = this->chains_.find(key);
+        if(found != this->chains_.end())
+        {
+            return found->second;
+        }
+        auto chain = std::make_shared<const chain_type>(this->parse_chain(rec));
+        this->chains_.emplace(key, chain);
+        return chain;
+    }
+
+    source_location location(const line_view& line,
+                             std::size_t first, std::size_t length) const
+    {
+        return source_location(this->filename_,
+                std::string(line.data, line.size), first, length, line.line_num);
+    }
+
+    std::string get_substr(const line_view& line,
+                           std::size_t first, std::size_t length) const
+    {
+        if(line.size < first)
+        {
+            log::error("couldn't get a sub-string",
+                       this->location(line, first, length), "here");
+            std::terminate();
+        }
+        return std::string(line.data + first,
+                           std::min(length, line.size - first));
+    }
+    char get_char_at(const line_view& line, std::size_t idx) const
+    {
+        if(line.size <= idx)
+        {
+            log::error("couldn't get a character",
+                       this->location(line, idx, 1), "here");
+            std::terminate();
+        }
+        return line.data[idx];
+    }
+    template<typename T>
+    T read_number(const line_view& line,
+                  std::size_t first, std::size_t length) const
+    {
+        if(line.size < first)
+        {
+            log::error("couldn't get a sub-string",
+                       this->location(line, first, length), "here");
+            std::terminate();
+        }
+        const char* beg = line.data + first;
+        const char* end = beg + std::min(length, line.size - first);
+
+        T value;
+        if(!parse_number(beg, end, value))
+        {
+            log::error("read_number: invalid number format",
+                       this->location(line, first, length), "here");
+            std::terminate();
+        }
+        return value;
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value, bool>::type
+    parse_number(const char* first, const char* last, T& value)
+    {
+        return parse_integer(first, last, value);
+    }
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+    parse_number(const char* first, const char* last, T& value)
+    {
+        return parse_real(first, last, value);
+    }
+
+    atom_type read_atom(const line_view& line) const
+    {
+        if(!line.starts_with("ATOM  ", 6))
+        {
+            log::error("internal error: not an ATOM line\n",
+                       this->location(line, 0, 6), "prefix is not \"ATOM\"\n");
             std::terminate();
         }
 
         atom_type atm;
 
         // these values are required
-        atm.atom_id      = read_number<std::int32_t>(src, 6, 5);
-        atm.atom_name    = get_substr (src, 12, 4);
-        atm.altloc       = get_char_at(src, 16   );
-        atm.residue_name = get_substr (src, 17, 3);
-        atm.chain_id     = get_char_at(src, 21   );
-        atm.residue_id   = read_number<std::int32_t>(src, 22, 4);
-        atm.icode        = get_char_at(src, 26   );
-        atm.position[0]  = read_number<real_type>(src, 30, 8);
-        atm.position[1]  = read_number<real_type>(src, 38, 8);
-        atm.position[2]  = read_number<real_type>(src, 46, 8);
-
-        if(atm.altloc != ' ')
-        {
-            src.column() = 16;
-            src.range()  =  1;
-            log::warn("pdb ATOM has alternative location code. "
-                                 "It may cause invalid parameters.\n");
-            log::warn(src, '\n');
-        }
+        atm.atom_id      = read_number<std::int32_t>(line, 6, 5);
+        atm.atom_name    = get_substr (line, 12, 4);
+        atm.altloc       = get_char_at(line, 16   );
+        atm.residue_name = get_substr (line, 17, 3);
+        atm.chain_id.assign(1, get_char_at(line, 21));
+        atm.residue_id   = read_number<std::int32_t>(line, 22, 4);
+        atm.icode        = get_char_at(line, 26   );
+        atm.position[0]  = read_number<real_type>(line, 30, 8);
+        atm.position[1]  = read_number<real_type>(line, 38, 8);
+        atm.position[2]  = read_number<real_type>(line, 46, 8);
 
         // allow files that lack the following values. default values are
         atm.occupancy          = 0.0;
@@ -101,62 +374,114 @@ class PDBReader
         atm.charge             = "  ";
 
         //XXX if the column exists, it should be a valid value.
-        if(line.size() < 60) {return atm;}
-        atm.occupancy = read_number<real_type>(src, 54, 6);
-        if(line.size() < 66) {return atm;}
-        atm.temperature_factor = read_number<real_type>(src, 60, 6);
-        if(line.size() < 78) {return atm;}
-        atm.element = get_substr(src, 76, 2);
-        if(line.size() < 80) {return atm;}
-        atm.charge  = get_substr(src, 78, 2);
+        if(line.size < 60) {return atm;}
+        atm.occupancy = read_number<real_type>(line, 54, 6);
+        if(line.size < 66) {return atm;}
+        atm.temperature_factor = read_number<real_type>(line, 60, 6);
+        if(line.size < 78) {return atm;}
+        atm.element = get_substr(line, 76, 2);
+        if(line.size < 80) {return atm;}
+        atm.charge  = get_substr(line, 78, 2);
 
         return atm;
     }
 
-    chain_type read_next_chain()
+    // parse ATOM records in [iter, last). Lines that have altloc are stored
+    // to warn later, so that the warnings are in the order of lines even if
+    // the chunks are parsed concurrently.
+    void parse_atoms(const char* iter, const char* last, std::size_t line_num,
+                     std::vector<atom_type>& atoms,
+                     std::vector<line_view>& altlocs) const
     {
-        std::vector<atom_type> atoms;
-        while(!this->is_eof())
+        // the block may contain other records like ANISOU. skip them.
+        while(iter != last)
         {
-            std::string line;
-            std::getline(ifstrm_, line);
-            this->line_num_ += 1;
-
-            if(line.size() >= 6 && line.substr(0, 6) == "ATOM  ")
+            const char* eol = std::find(iter, last, '\n');
+            const line_view line{iter, static_cast<std::size_t>(eol - iter), line_num};
+            if(line.starts_with("ATOM  ", 6))
             {
                 atoms.push_back(this->read_atom(line));
-            }
-            else if((line.size() >= 3 && line.substr(0, 3) == "TER") ||
-                    (line.size() >= 6 && line.substr(0, 6) == "ENDMDL"))
-            {
-                if(!atoms.empty())
+                if(atoms.back().altloc != ' ')
                 {
-                    log::info("PDBReader: read chain ",
-                        atoms.front().chain_id, ".\n");
+                    altlocs.push_back(line);
                 }
-                return chain_type(std::move(atoms));
             }
-            continue;
+            iter = (eol == last) ? last : eol + 1;
+            line_num += 1;
         }
-        if(!atoms.empty())
+        return;
+    }
+
+    chain_type parse_chain(const PDBChainRecord& rec)
+    {
+        // a chunk should be large enough to hide the cost of a thread.
+        constexpr std::size_t min_chunk_size = 64 * 1024;
+
+        const char* first = this->file_.begin() + rec.first;
+        const char* last  = this->file_.begin() + rec.last;
+        const std::size_t num_chunks = std::max<std::size_t>(1, std::min(
+                this->num_threads_ * 4, (rec.last - rec.first) / min_chunk_size));
+
+        // split the block at line boundaries.
+        std::vector<const char*> bounds(1, first);
+        for(std::size_t i=1; i<num_chunks; ++i)
+        {
+            const char* pos = std::max(bounds.back(),
+                    first + (rec.last - rec.first) * i / num_chunks);
+            pos = std::find(pos, last, '\n');
+            if(pos == last) {break;}
+            if(bounds.back() < pos + 1) {bounds.push_back(pos + 1);}
+        }
+        bounds.push_back(last);
+        const std::size_t num_blocks = bounds.size() - 1;
+
+        // line number of the first line in each chunk. It is needed only
+        // when an error is reported, but counting lines is cheap.
+        std::vector<std::size_t> line_nums(num_blocks, 0);
+        parallel_for(this->num_threads_, 1, num_blocks, [&](std::size_t i) {
+                line_nums[i] = std::count(bounds[i-1], bounds[i], '\n');
+            });
+        line_nums.front() = rec.line;
+        for(std::size_t i=1; i<num_blocks; ++i)
+        {
+            line_nums[i] += line_nums[i-1];
+        }
+
+        std::vector<std::vector<atom_type>> atoms_per_chunk(num_blocks);
+        std::vector<std::vector<line_view>> altlocs_per_chunk(num_blocks);
+        parallel_for(this->num_threads_, 0, num_blocks, [&](std::size_t i) {
+                this->parse_atoms(bounds[i], bounds[i+1], line_nums[i],
+                                  atoms_per_chunk[i], altlocs_per_chunk[i]);
+            });
+
+        std::vector<atom_type> atoms(std::move(atoms_per_chunk.front()));
+        for(std::size_t i=1; i<num_blocks; ++i)
         {
-            log::info("PDBReader: read chain ",
-                atoms.front().chain_id, ".\n");
-            return chain_type(std::move(atoms));
+            atoms.insert(atoms.end(),
+                         std::make_move_iterator(atoms_per_chunk[i].begin()),
+                         std::make_move_iterator(atoms_per_chunk[i].end()));
+        }
+        for(const auto& altlocs : altlocs_per_chunk)
+        {
+            for(const auto& line : altlocs)
+            {
+                log::warn("pdb ATOM has alternative location code. "
+                                     "It may cause invalid parameters.\n");
+                log::warn(this->location(line, 16, 1), '\n');
+            }
         }
-        log::error("PDBReader: ", filename_, " does not contain ",
-                              "chains any more\n");
-        std::terminate();
+        log::info("PDBReader: read chain ", rec.chain_id, ".\n");
+        return chain_type(std::move(atoms));
     }
 
   private:
 
-    std::size_t line_num_;
-    std::string filename_;
-    std::ifstream ifstrm_;
+    std::string   filename_;
+    mapped_file   file_;
+    PDBChainIndex index_;
 
     // store chains already read
-    std::vector<chain_type> chains_;
+    std::map<PDBChainIndex::key_type, chain_ptr> chains_;
 };
 
 } // jarngreipr
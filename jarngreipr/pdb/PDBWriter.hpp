@@ -47,7 +47,7 @@ class PDBWriter
         this->ofstrm_ << atm.altloc;
         this->ofstrm_ << std::left  << std::setw(3) << atm.residue_name;
         this->ofstrm_ << ' ';
-        this->ofstrm_ << atm.chain_id;
+        this->ofstrm_ << (atm.chain_id.empty() ? ' ' : atm.chain_id.front());
         this->ofstrm_ << std::right << std::setw(4) << atm.residue_id;
         this->ofstrm_ << atm.icode;
         this->ofstrm_ << "   ";
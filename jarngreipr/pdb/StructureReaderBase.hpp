@@ -0,0 +1,66 @@
+#ifndef JARNGREIPR_PDB_STRUCTURE_READER_BASE_HPP
+#define JARNGREIPR_PDB_STRUCTURE_READER_BASE_HPP
+#include <jarngreipr/pdb/PDBChain.hpp>
+#include <jarngreipr/geometry/SymmetryOperator.hpp>
+#include <jarngreipr/util/log.hpp>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace jarngreipr
+{
+
+// common interface of the readers that produce PDBChains from a structure
+// file, e.g. PDBReader and MMCIFReader.
+template<typename realT>
+class StructureReaderBase
+{
+  public:
+    using real_type     = realT;
+    using chain_type    = PDBChain<real_type>;
+    using chain_ptr     = std::shared_ptr<const chain_type>;
+    using operator_type = SymmetryOperator<real_type>;
+
+  public:
+
+    explicit StructureReaderBase(const std::size_t num_threads)
+        : num_threads_(std::max<std::size_t>(num_threads, 1))
+    {}
+    virtual ~StructureReaderBase() = default;
+
+    // CG beads refer to the atoms in the chain, so the chain is shared.
+    // If the file has several models, the first chain with the ID is used.
+    virtual chain_ptr read_chain(const std::string& id) = 0;
+    // a chain in the model that has the serial number, e.g. of an NMR ensemble.
+    // It does not parse the other models.
+    virtual chain_ptr read_chain(const std::string& id, const std::int32_t model) = 0;
+
+    // serial numbers of the models in the order of appearance.
+    virtual std::vector<std::int32_t> models() const = 0;
+
+    // operators that generate a biological assembly from the asymmetric unit.
+    // They are applied to all the `chains`. Formats that do not support it
+    // terminate the program.
+    virtual std::vector<operator_type> biomt(const std::int32_t biomolecule,
+            const std::vector<std::string>& /* chains */) const
+    {
+        log::error("this structure file does not support BIOMT (biomolecule ",
+                   biomolecule, ").\n");
+        std::terminate();
+    }
+
+    std::size_t num_threads() const noexcept {return num_threads_;}
+    void set_num_threads(const std::size_t n) noexcept
+    {
+        this->num_threads_ = std::max<std::size_t>(n, 1);
+    }
+
+  protected:
+
+    std::size_t num_threads_;
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_PDB_STRUCTURE_READER_BASE_HPP
@@ -0,0 +1,82 @@
+#ifndef JARNGREIPR_PDB_ATOM_CLASS_HPP
+#define JARNGREIPR_PDB_ATOM_CLASS_HPP
+#include <jarngreipr/pdb/PDBAtom.hpp>
+#include <cstdint>
+
+// classification of PDB atoms. CGBead caches it for ForceFieldGenerators
+
+namespace jarngreipr
+{
+
+// chemical classes of an atom that are used to count atomic contacts.
+// an atom may belong to several classes, e.g. the backbone O is a backbone
+// atom and an acceptor.
+namespace atom_class
+{
+enum flag : std::uint8_t
+{
+    backbone  = 0x01,
+    sidechain = 0x02,
+    donor     = 0x04,
+    acceptor  = 0x08,
+    cation    = 0x10,
+    anion     = 0x20,
+    carbon    = 0x40
+};
+} // atom_class
+
+// classify an atom by its atom name and residue name. It compares strings,
+// so the result should be computed once and cached.
+template<typename realT>
+std::uint8_t classify_atom(const PDBAtom<realT>& atom)
+{
+    const auto& name = atom.atom_name;
+    const auto& res  = atom.residue_name;
+
+    std::uint8_t flags = 0;
+
+    const bool is_backbone = (name == " N  " || name == " C  " ||
+        name == " O  " || name == " OXT" || name == " CA ");
+    if(is_backbone)
+    {
+        flags |= atom_class::backbone;
+    }
+    else if(name.at(0) != 'H' && name.at(1) != 'H')
+    {
+        flags |= atom_class::sidechain;
+    }
+
+    if(name.at(1) == 'N' ||
+       (res == "SER" && name == " OG ") ||
+       (res == "THR" && name == " OG1") ||
+       (res == "TYR" && name == " OH ") ||
+       (res == "CYS" && name.at(1) == 'S'))
+    {
+        flags |= atom_class::donor;
+    }
+    if(name.at(1) == 'O' || name.at(1) == 'S')
+    {
+        flags |= atom_class::acceptor;
+    }
+    if((res == "ARG" && name == " NH1") ||
+       (res == "ARG" && name == " NH2") ||
+       (res == "LYS" && name == " NZ "))
+    {
+        flags |= atom_class::cation;
+    }
+    if((res == "GLU" && name == " OE1") ||
+       (res == "GLU" && name == " OE2") ||
+       (res == "ASP" && name == " OD1") ||
+       (res == "ASP" && name == " OD2"))
+    {
+        flags |= atom_class::anion;
+    }
+    if(name.at(1) == 'C')
+    {
+        flags |= atom_class::carbon;
+    }
+    return flags;
+}
+
+} // jarngreipr
+#endif//JARNGREIPR_PDB_ATOM_CLASS_HPP
@@ -0,0 +1,60 @@
+#ifndef JARNGREIPR_PDB_REMOVE_HYDROGENS_HPP
+#define JARNGREIPR_PDB_REMOVE_HYDROGENS_HPP
+#include <jarngreipr/util/log.hpp>
+#include <jarngreipr/pdb/PDBAtom.hpp>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cassert>
+
+// utility functions on PDB atoms, used by CGBead to select heavy atoms
+
+namespace jarngreipr
+{
+
+template<typename realT>
+bool is_hydrogen(const PDBAtom<realT>& atom)
+{
+    assert(atom.element.size() == 2);
+    assert(atom.atom_name.size() == 4);
+
+    // wwPDB v3 conformant (should be right justified, but allow...)
+    if(atom.element == " H" || atom.element == "H ") {return true;}
+    if(atom.atom_name.at(1) == 'H')
+    {
+        return true;
+    }
+
+    // older or something others
+    std::string buf = atom.atom_name;
+    while(buf.front() == ' ') {buf.erase(buf.begin());}
+    if(buf.front() == 'H')
+    {
+        if(atom.element == "Hg" || atom.element == "HG" ||
+           atom.element == "Hf" || atom.element == "HF" ||
+           atom.element == "Ho" || atom.element == "HO" ||
+           atom.element == "Hs" || atom.element == "HS")
+        {
+            return false;
+        }
+        log::warn("Atom name starting with H found. "
+                             "Considering it as a hydrogen.\n");
+        log::warn("If it is not a hydrogen, "
+                             "add element symbol section.\n");
+        log::warn(atom, '\n');
+        return true;
+    }
+    return false;
+}
+
+template<typename realT>
+std::vector<PDBAtom<realT>> remove_hydrogens(std::vector<PDBAtom<realT>> atoms)
+{
+    const auto removed = std::remove_if(atoms.begin(), atoms.end(),
+        [](const PDBAtom<realT>& atom) -> bool {return is_hydrogen(atom);});
+    atoms.erase(removed, atoms.end());
+    return atoms;
+}
+
+} // jarngreipr
+#endif//JARNGREIPR_PDB_REMOVE_HYDROGENS_HPP
@@ -0,0 +1,217 @@
+#ifndef JARNGREIPR_UTIL_GZIP_HPP
+#define JARNGREIPR_UTIL_GZIP_HPP
+#include <algorithm>
+#include <istream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <climits>
+#include <cstdio>
+#include <zlib.h>
+
+namespace jarngreipr
+{
+
+// gzip-compressed data starts with the magic number 1f 8b.
+inline bool is_gzip(const char* data, const std::size_t size) noexcept
+{
+    return 2 <= size && static_cast<unsigned char>(data[0]) == 0x1f &&
+                        static_cast<unsigned char>(data[1]) == 0x8b;
+}
+
+// decompress gzip data in [data, data+size) and append it to `out`.
+// Concatenated gzip members (e.g. bgzip) are also supported.
+// It returns false if the data is broken.
+inline bool gunzip(const char* data, const std::size_t size, std::vector<char>& out)
+{
+    // the last 4 bytes of a member is the uncompressed size modulo 2^32.
+    // it is exact for a single-member file smaller than 4 GiB. It is read
+    // before the data is validated, so it is capped by the maximum ratio of
+    // deflate (about 1032:1) to avoid a huge allocation for a broken file.
+    if(8 <= size)
+    {
+        const unsigned char* tail =
+            reinterpret_cast<const unsigned char*>(data + size - 4);
+        const std::size_t hint = tail[0] | (tail[1] << 8) | (tail[2] << 16) |
+                                 (static_cast<std::size_t>(tail[3]) << 24);
+        out.reserve(out.size() + std::min<std::size_t>(hint, size * 1032));
+    }
+
+    z_stream strm;
+    strm.zalloc   = Z_NULL;
+    strm.zfree    = Z_NULL;
+    strm.opaque   = Z_NULL;
+    strm.next_in  = Z_NULL;
+    strm.avail_in = 0;
+    if(inflateInit2(&strm, 15 + 16) != Z_OK) // 15+16: gzip format only
+    {
+        return false;
+    }
+
+    const std::size_t chunk = 256 * 1024;
+    std::size_t consumed = 0;
+    int status = Z_OK;
+    while(true)
+    {
+        if(strm.avail_in == 0 && consumed < size)
+        {
+            const std::size_t n = std::min<std::size_t>(size - consumed, UINT_MAX);
+            strm.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(data + consumed));
+            strm.avail_in = static_cast<uInt>(n);
+            consumed += n;
+        }
+
+        const std::size_t offset = out.size();
+        out.resize(offset + chunk);
+        strm.next_out  = reinterpret_cast<Bytef*>(out.data() + offset);
+        strm.avail_out = static_cast<uInt>(chunk);
+
+        status = inflate(&strm, Z_NO_FLUSH);
+        out.resize(out.size() - strm.avail_out);
+
+        if(status == Z_STREAM_END)
+        {
+            // skip the padding zeros, and restart if another member follows.
+            while(strm.avail_in != 0 && *strm.next_in == 0)
+            {
+                ++strm.next_in;
+                --strm.avail_in;
+            }
+            if(strm.avail_in == 0 && consumed == size) {break;}
+            if(inflateReset(&strm) != Z_OK) {status = Z_STREAM_ERROR; break;}
+            status = Z_OK;
+        }
+        else if(status != Z_OK && status != Z_BUF_ERROR)
+        {
+            break; // broken data
+        }
+        else if(status == Z_BUF_ERROR && strm.avail_in == 0 && consumed == size)
+        {
+            break; // truncated
+        }
+    }
+    inflateEnd(&strm);
+    return status == Z_STREAM_END;
+}
+
+// streambuf that reads a file through zlib. It reads gzip-compressed files
+// and uncompressed files in the same way.
+class gzstreambuf : public std::streambuf
+{
+  public:
+
+    gzstreambuf(): file_(nullptr) {this->setg(buffer_, buffer_, buffer_);}
+    ~gzstreambuf() override {this->close();}
+
+    gzstreambuf(const gzstreambuf&)            = delete;
+    gzstreambuf& operator=(const gzstreambuf&) = delete;
+
+    bool is_open() const noexcept {return file_ != nullptr;}
+
+    gzstreambuf* open(const std::string& fname)
+    {
+        if(this->is_open()) {return nullptr;}
+        this->file_ = gzopen(fname.c_str(), "rb");
+        if(!this->file_) {return nullptr;}
+        gzbuffer(this->file_, 128 * 1024);
+        this->setg(buffer_, buffer_, buffer_);
+        return this;
+    }
+    gzstreambuf* close()
+    {
+        if(!this->is_open()) {return nullptr;}
+        gzclose(this->file_);
+        this->file_ = nullptr;
+        this->setg(buffer_, buffer_, buffer_);
+        return this;
+    }
+
+  protected:
+
+    int_type underflow() override
+    {
+        if(this->gptr() < this->egptr())
+        {
+            return traits_type::to_int_type(*this->gptr());
+        }
+        if(!this->is_open()) {return traits_type::eof();}
+
+        const int n = gzread(this->file_, buffer_, sizeof(buffer_));
+        if(n <= 0)
+        {
+            // a truncated or broken file is not a normal EOF. The exception
+            // is caught by std::istream and it sets badbit.
+            int errnum = Z_OK;
+            const char* msg = gzerror(this->file_, &errnum);
+            if(errnum != Z_OK)
+            {
+                throw std::runtime_error(std::string("gzstreambuf: ") + msg);
+            }
+            return traits_type::eof();
+        }
+
+        this->setg(buffer_, buffer_, buffer_ + n);
+        return traits_type::to_int_type(*this->gptr());
+    }
+
+    // seeking backward restarts decompression from the beginning. It is
+    // mainly used to rewind the file.
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode) override
+    {
+        if(!this->is_open() || dir == std::ios_base::end)
+        {
+            return pos_type(off_type(-1));
+        }
+        const off_type current = gztell(this->file_) - (this->egptr() - this->gptr());
+        const off_type target  = (dir == std::ios_base::beg) ? off : current + off;
+        if(gzseek(this->file_, static_cast<z_off_t>(target), SEEK_SET) < 0)
+        {
+            return pos_type(off_type(-1));
+        }
+        this->setg(buffer_, buffer_, buffer_);
+        return pos_type(target);
+    }
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+    {
+        return this->seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+  private:
+
+    gzFile file_;
+    char   buffer_[64 * 1024];
+};
+
+// drop-in replacement of std::ifstream that also reads gzip-compressed files.
+class igzstream : public std::istream
+{
+  public:
+
+    igzstream(): std::istream(nullptr) {this->rdbuf(&buf_);}
+    explicit igzstream(const std::string& fname): std::istream(nullptr)
+    {
+        this->rdbuf(&buf_);
+        this->open(fname);
+    }
+
+    bool is_open() const noexcept {return buf_.is_open();}
+
+    void open(const std::string& fname)
+    {
+        if(buf_.open(fname)) {this->clear();}
+        else                 {this->setstate(std::ios_base::failbit);}
+    }
+    void close()
+    {
+        if(!buf_.close()) {this->setstate(std::ios_base::failbit);}
+    }
+
+  private:
+
+    gzstreambuf buf_;
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_UTIL_GZIP_HPP
@@ -0,0 +1,35 @@
+#ifndef JARNGREIPR_UTIL_HASH_HPP
+#define JARNGREIPR_UTIL_HASH_HPP
+#include <string>
+#include <cstdint>
+
+namespace jarngreipr
+{
+
+// 64-bit FNV-1a hash. It is not cryptographic, but enough to detect that
+// the inputs of a cached result have been changed.
+constexpr std::uint64_t fnv1a_offset_basis = 0xcbf29ce484222325ull;
+constexpr std::uint64_t fnv1a_prime        = 0x00000100000001b3ull;
+
+inline std::uint64_t hash_bytes(const char* data, const std::size_t size,
+        std::uint64_t seed = fnv1a_offset_basis) noexcept
+{
+    for(std::size_t i=0; i<size; ++i)
+    {
+        seed ^= static_cast<unsigned char>(data[i]);
+        seed *= fnv1a_prime;
+    }
+    return seed;
+}
+
+// the length is also hashed so that {"ab", "c"} and {"a", "bc"} differ.
+inline std::uint64_t hash_string(const std::string& str,
+        std::uint64_t seed = fnv1a_offset_basis) noexcept
+{
+    const std::uint64_t len = str.size();
+    seed = hash_bytes(reinterpret_cast<const char*>(&len), sizeof(len), seed);
+    return hash_bytes(str.data(), str.size(), seed);
+}
+
+} // jarngreipr
+#endif// JARNGREIPR_UTIL_HASH_HPP
@@ -0,0 +1,117 @@
+#ifndef JARNGREIPR_UTIL_MAPPED_FILE_HPP
+#define JARNGREIPR_UTIL_MAPPED_FILE_HPP
+#include <jarngreipr/util/log.hpp>
+#include <jarngreipr/util/gzip.hpp>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace jarngreipr
+{
+
+//
+// read-only contents of a file.
+//
+// A regular file is mapped onto the memory, so reading it does not allocate
+// and pages are loaded on demand. If the file cannot be mapped (e.g. a pipe),
+// the contents are read into a buffer instead. A gzip-compressed file is
+// decompressed into a buffer.
+//
+class mapped_file
+{
+  public:
+
+    explicit mapped_file(const std::string& fname)
+        : data_(nullptr), size_(0), mapped_(nullptr), mapped_size_(0)
+    {
+        const int fd = ::open(fname.c_str(), O_RDONLY);
+        if(fd < 0)
+        {
+            log::error("mapped_file: file open error: ", fname, '\n');
+            std::terminate();
+        }
+        struct stat st;
+        if(::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && 0 < st.st_size)
+        {
+            void* ptr = ::mmap(nullptr, static_cast<std::size_t>(st.st_size),
+                               PROT_READ, MAP_PRIVATE, fd, 0);
+            if(ptr != MAP_FAILED)
+            {
+                ::madvise(ptr, static_cast<std::size_t>(st.st_size),
+                          MADV_SEQUENTIAL);
+                this->mapped_      = ptr;
+                this->mapped_size_ = static_cast<std::size_t>(st.st_size);
+                this->data_        = static_cast<const char*>(ptr);
+                this->size_        = this->mapped_size_;
+            }
+        }
+        ::close(fd);
+
+        if(!this->mapped_)
+        {
+            std::ifstream ifs(fname, std::ios::binary);
+            if(!ifs.good())
+            {
+                log::error("mapped_file: file open error: ", fname, '\n');
+                std::terminate();
+            }
+            this->buffer_.assign(std::istreambuf_iterator<char>(ifs),
+                                 std::istreambuf_iterator<char>());
+            this->data_ = this->buffer_.data();
+            this->size_ = this->buffer_.size();
+        }
+
+        if(is_gzip(this->data_, this->size_))
+        {
+            std::vector<char> decompressed;
+            if(!gunzip(this->data_, this->size_, decompressed))
+            {
+                log::error("mapped_file: failed to decompress: ", fname, '\n');
+                std::terminate();
+            }
+            this->unmap();
+            this->buffer_.swap(decompressed);
+            this->data_ = this->buffer_.data();
+            this->size_ = this->buffer_.size();
+        }
+    }
+    ~mapped_file() {this->unmap();}
+
+    mapped_file(const mapped_file&)            = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    mapped_file(mapped_file&&)                 = delete;
+    mapped_file& operator=(mapped_file&&)      = delete;
+
+    const char* data()  const noexcept {return data_;}
+    std::size_t size()  const noexcept {return size_;}
+    const char* begin() const noexcept {return data_;}
+    const char* end()   const noexcept {return data_ + size_;}
+
+  private:
+
+    void unmap() noexcept
+    {
+        if(this->mapped_)
+        {
+            ::munmap(this->mapped_, this->mapped_size_);
+            this->mapped_      = nullptr;
+            this->mapped_size_ = 0;
+        }
+    }
+
+  private:
+
+    const char*       data_;
+    std::size_t       size_;
+    void*             mapped_;
+    std::size_t       mapped_size_;
+    std::vector<char> buffer_; // used if the file is not mapped
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_UTIL_MAPPED_FILE_HPP
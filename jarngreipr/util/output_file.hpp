@@ -0,0 +1,154 @@
+#ifndef JARNGREIPR_UTIL_OUTPUT_FILE_HPP
+#define JARNGREIPR_UTIL_OUTPUT_FILE_HPP
+#include <jarngreipr/util/log.hpp>
+#include <streambuf>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace jarngreipr
+{
+
+//
+// streambuf that writes to a file through a large buffer.
+//
+// The buffer is passed to write(2) only when it is full, so writing a large
+// file issues a few syscalls per megabyte. A chunk that is larger than the
+// buffer is written directly without copying.
+//
+class file_sink : public std::streambuf
+{
+  public:
+
+    explicit file_sink(const std::string& fname,
+                       const std::size_t capacity = 1 << 20)
+        : fname_(fname), fd_(-1), buffer_(capacity)
+    {
+        this->fd_ = ::open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(this->fd_ < 0)
+        {
+            log::error("file_sink: file open error: ", fname, '\n');
+            std::terminate();
+        }
+#if defined(POSIX_FADV_SEQUENTIAL)
+        // the file is written from the beginning to the end.
+        ::posix_fadvise(this->fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        this->setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+    ~file_sink() override {this->close();}
+
+    file_sink(const file_sink&)            = delete;
+    file_sink& operator=(const file_sink&) = delete;
+
+    void close()
+    {
+        if(this->fd_ < 0) {return;}
+        this->flush_buffer();
+
+        // some filesystems (e.g. NFS) report write errors only on close.
+        // On Linux, the descriptor is released even if it returns EINTR.
+        const int status = ::close(this->fd_);
+        this->fd_ = -1;
+        if(status != 0 && errno != EINTR)
+        {
+            log::error("file_sink: failed to write to ", fname_, '\n');
+            std::terminate();
+        }
+        return;
+    }
+
+  protected:
+
+    int_type overflow(int_type c) override
+    {
+        this->flush_buffer();
+        if(!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            *this->pptr() = traits_type::to_char_type(c);
+            this->pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char_type* s, std::streamsize n) override
+    {
+        if(static_cast<std::size_t>(n) < buffer_.size())
+        {
+            return std::streambuf::xsputn(s, n);
+        }
+        this->flush_buffer();
+        this->write_all(s, static_cast<std::size_t>(n));
+        return n;
+    }
+
+    int sync() override
+    {
+        this->flush_buffer();
+        return 0;
+    }
+
+  private:
+
+    void flush_buffer()
+    {
+        this->write_all(this->pbase(),
+                        static_cast<std::size_t>(this->pptr() - this->pbase()));
+        this->setp(buffer_.data(), buffer_.data() + buffer_.size());
+        return;
+    }
+
+    void write_all(const char* s, std::size_t n)
+    {
+        while(n != 0)
+        {
+            const auto written = ::write(this->fd_, s, n);
+            if(written < 0)
+            {
+                if(errno == EINTR) {continue;}
+                log::error("file_sink: failed to write to ", fname_, '\n');
+                std::terminate();
+            }
+            s += written;
+            n -= static_cast<std::size_t>(written);
+        }
+        return;
+    }
+
+  private:
+
+    std::string       fname_;
+    int               fd_;
+    std::vector<char> buffer_;
+};
+
+// std::ostream that writes to a file through file_sink.
+class output_file : public std::ostream
+{
+  public:
+
+    explicit output_file(const std::string& fname,
+                         const std::size_t capacity = 1 << 20)
+        : std::ostream(nullptr), sink_(fname, capacity)
+    {
+        this->rdbuf(&sink_);
+    }
+    ~output_file() override {this->close();}
+
+    void close()
+    {
+        this->flush();
+        this->sink_.close();
+        return;
+    }
+
+  private:
+
+    file_sink sink_;
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_UTIL_OUTPUT_FILE_HPP
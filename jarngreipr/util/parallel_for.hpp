@@ -0,0 +1,27 @@
+#ifndef JARNGREIPR_UTIL_PARALLEL_FOR_HPP
+#define JARNGREIPR_UTIL_PARALLEL_FOR_HPP
+#include <jarngreipr/util/thread_pool.hpp>
+#include <algorithm>
+
+namespace jarngreipr
+{
+
+// call `f(i)` for each i in [first, last) using `num_threads` threads.
+//
+// This starts and joins its own threads, so it is meant for a few large loops.
+// A loop that runs many times should use a ThreadPool that outlives it.
+// See ThreadPool::parallel_for for the order of calls and exceptions.
+// If `num_threads` is 0 or 1, `f` is called in order on the current thread.
+template<typename F>
+void parallel_for(const std::size_t num_threads,
+                  const std::size_t first, const std::size_t last, F&& f)
+{
+    if(last <= first) {return;}
+
+    ThreadPool pool(std::min(num_threads, last - first));
+    pool.parallel_for(first, last, std::forward<F>(f));
+    return;
+}
+
+} // jarngreipr
+#endif// JARNGREIPR_UTIL_PARALLEL_FOR_HPP
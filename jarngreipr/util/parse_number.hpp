@@ -0,0 +1,166 @@
+#ifndef JARNGREIPR_UTIL_PARSE_NUMBER_HPP
+#define JARNGREIPR_UTIL_PARSE_NUMBER_HPP
+#include <type_traits>
+#include <limits>
+#include <string>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdint>
+
+// allocation-free number parsers for fixed-width columns. Unlike read_number,
+// they take a range of characters and return false on error, so the caller
+// builds a source_location only when it reports the error.
+
+namespace jarngreipr
+{
+namespace detail
+{
+inline bool is_space_char(const char c) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+inline bool is_digit_char(const char c) noexcept
+{
+    return '0' <= c && c <= '9';
+}
+
+inline double      strtor(const char* s, char** e, double)      {return std::strtod (s, e);}
+inline float       strtor(const char* s, char** e, float)       {return std::strtof (s, e);}
+inline long double strtor(const char* s, char** e, long double) {return std::strtold(s, e);}
+
+// the same as std::sto[fdl] but without throwing. used for uncommon formats.
+template<typename T>
+bool parse_real_fallback(const char* first, const char* last, T& value)
+{
+    char buf[64];
+    std::string str; // used only if the field is too long
+    const char* cstr = buf;
+    const std::size_t len = static_cast<std::size_t>(last - first);
+    if(len < sizeof(buf))
+    {
+        std::copy(first, last, buf);
+        buf[len] = '\0';
+    }
+    else
+    {
+        str.assign(first, last);
+        cstr = str.c_str();
+    }
+    char* end = nullptr;
+    errno = 0;
+    const T v = strtor(cstr, &end, T());
+    if(end == cstr || errno == ERANGE)
+    {
+        return false;
+    }
+    value = v;
+    return true;
+}
+} // detail
+
+// parse an integer in the same way as std::stoi; leading whitespaces and a
+// sign are allowed, and it stops at the first non-digit character.
+// It returns false if there is no digit or the value overflows.
+template<typename T>
+bool parse_integer(const char* first, const char* last, T& value) noexcept
+{
+    static_assert(std::is_integral<T>::value, "");
+
+    while(first != last && detail::is_space_char(*first)) {++first;}
+
+    bool negative = false;
+    if(first != last && (*first == '+' || *first == '-'))
+    {
+        negative = (*first == '-');
+        ++first;
+    }
+    if(first == last || !detail::is_digit_char(*first))
+    {
+        return false;
+    }
+    if(negative && std::is_unsigned<T>::value && *first != '0')
+    {
+        return false;
+    }
+
+    // max magnitude of the value. e.g. 2^31 for negative std::int32_t.
+    const std::uint64_t limit = negative ?
+        static_cast<std::uint64_t>(-(std::numeric_limits<T>::min() + 1)) + 1 :
+        static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+
+    std::uint64_t acc = 0;
+    for(; first != last && detail::is_digit_char(*first); ++first)
+    {
+        const std::uint64_t d = static_cast<std::uint64_t>(*first - '0');
+        if((limit - d) / 10 < acc)
+        {
+            return false; // overflow
+        }
+        acc = acc * 10 + d;
+    }
+    value = negative ? static_cast<T>(-static_cast<std::int64_t>(acc - 1) - 1) :
+                       static_cast<T>(acc);
+    return true;
+}
+
+// parse a real number in the same way as std::stod.
+//
+// A plain decimal number like "-12.345", which is the case for almost all the
+// fixed-width files, is converted by dividing the integer mantissa by a power
+// of ten. Both are exact and IEEE division is correctly rounded, so the result
+// is the same as std::stod. Other formats (exponents, too many digits, inf,
+// etc.) are passed to std::strtod.
+template<typename T>
+bool parse_real(const char* first, const char* last, T& value)
+{
+    static_assert(std::is_floating_point<T>::value, "");
+    constexpr std::size_t max_fraction = 10; // 10^10 is exact in float
+    static const T pow10[max_fraction + 1] = {
+        T(1e0), T(1e1), T(1e2), T(1e3), T(1e4), T(1e5),
+        T(1e6), T(1e7), T(1e8), T(1e9), T(1e10)
+    };
+
+    const char* iter = first;
+    while(iter != last && detail::is_space_char(*iter)) {++iter;}
+
+    bool negative = false;
+    if(iter != last && (*iter == '+' || *iter == '-'))
+    {
+        negative = (*iter == '-');
+        ++iter;
+    }
+
+    std::uint64_t mantissa   = 0;
+    std::size_t   num_digits = 0;
+    std::size_t   fraction   = 0;
+    for(; iter != last && detail::is_digit_char(*iter); ++iter)
+    {
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(*iter - '0');
+        ++num_digits;
+        if(num_digits > std::numeric_limits<T>::digits10) {break;}
+    }
+    if(iter != last && *iter == '.')
+    {
+        ++iter;
+        for(; iter != last && detail::is_digit_char(*iter); ++iter)
+        {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*iter - '0');
+            ++num_digits;
+            ++fraction;
+            if(num_digits > std::numeric_limits<T>::digits10) {break;}
+        }
+    }
+    const bool has_exponent = (iter != last && (*iter == 'e' || *iter == 'E'));
+    const bool is_too_long  = (iter != last && detail::is_digit_char(*iter));
+
+    if(num_digits == 0 || has_exponent || is_too_long || max_fraction < fraction)
+    {
+        return detail::parse_real_fallback(first, last, value);
+    }
+    const T v = static_cast<T>(mantissa) / pow10[fraction];
+    value = negative ? -v : v;
+    return true;
+}
+
+} // jarngreipr
+#endif// JARNGREIPR_UTIL_PARSE_NUMBER_HPP
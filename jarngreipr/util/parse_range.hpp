@@ -50,7 +50,10 @@ typename std::enable_if<std::is_integral<integerT>::value, std::vector<integerT>
 
 //
 // "A:D" -> ["A", "B", "C", "D"]
+// "AA"  -> ["AA"]
 //
+// A range is defined only for 1-letter chain IDs. A multi-letter ID, e.g. of
+// mmCIF files, should be given as it is.
 inline std::vector<std::string> parse_chain_range(std::string str)
 {
     while(str.front() == ' ') {str.erase(str.begin());}
@@ -60,12 +63,12 @@ inline std::vector<std::string> parse_chain_range(std::string str)
     std::smatch sm;
     if(!std::regex_match(str, sm, syntax))
     {
-        if(str.size() == 1u && std::isupper(str.at(0)) != 0)
+        if(std::regex_match(str, std::regex(R"([A-Za-z0-9]+)")))
         {
             return std::vector<std::string>{str};
         }
         log::error("syntax error in range \"", str, "\"\n");
-        log::error("expected like: \"A:D\", \"C:F\"\n");
+        log::error("expected like: \"A:D\", \"C:F\", \"AA\"\n");
         return {};
     }
     const auto front = sm.str(2);
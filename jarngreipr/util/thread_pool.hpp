@@ -0,0 +1,163 @@
+#ifndef JARNGREIPR_UTIL_THREAD_POOL_HPP
+#define JARNGREIPR_UTIL_THREAD_POOL_HPP
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jarngreipr
+{
+
+//
+// A set of threads that lives as long as the pool and runs `parallel_for`.
+//
+// The thread that calls `parallel_for` also works, so a pool of N threads
+// spawns N-1 workers. Workers sleep while no job is given. A pool runs one
+// job at a time; `parallel_for` should not be called from inside a job.
+//
+class ThreadPool
+{
+  public:
+
+    explicit ThreadPool(const std::size_t num_threads)
+        : num_threads_(std::max<std::size_t>(num_threads, 1)),
+          generation_(0), running_(0), stop_(false)
+    {
+        this->workers_.reserve(this->num_threads_ - 1);
+        for(std::size_t i=1; i<this->num_threads_; ++i)
+        {
+            this->workers_.emplace_back([this]() -> void {this->work();});
+        }
+    }
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mtx_);
+            this->stop_ = true;
+        }
+        this->start_.notify_all();
+        for(auto& th : this->workers_)
+        {
+            th.join();
+        }
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&)      = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&)      = delete;
+
+    std::size_t size() const noexcept {return num_threads_;}
+
+    // call `f(i)` for each i in [first, last).
+    //
+    // Indices are handed out one by one, so rows that have very different
+    // costs are balanced among the threads. The order of calls is not
+    // specified; `f` should write its result to a slot owned by `i`.
+    // If `f` throws, the remaining indices are skipped and the first
+    // exception is rethrown on the calling thread after all workers stop.
+    template<typename F>
+    void parallel_for(const std::size_t first, const std::size_t last, F&& f)
+    {
+        if(last <= first) {return;}
+        if(this->workers_.empty() || last - first == 1)
+        {
+            for(std::size_t i=first; i<last; ++i)
+            {
+                f(i);
+            }
+            return;
+        }
+
+        std::atomic<std::size_t> next(first);
+        std::exception_ptr       error;
+        std::mutex               error_mtx;
+        const std::function<void()> job = [&]() -> void {
+            try
+            {
+                for(std::size_t i = next++; i < last; i = next++)
+                {
+                    f(i);
+                }
+            }
+            catch(...)
+            {
+                next = last; // the other threads stop at the next index
+                std::lock_guard<std::mutex> lock(error_mtx);
+                if(!error) {error = std::current_exception();}
+            }
+            return;
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(this->mtx_);
+            this->job_     = &job;
+            this->running_ = this->workers_.size();
+            this->generation_ += 1;
+        }
+        this->start_.notify_all();
+
+        job(); // the current thread also works
+
+        {
+            std::unique_lock<std::mutex> lock(this->mtx_);
+            this->done_.wait(lock, [this]{return this->running_ == 0;});
+            this->job_ = nullptr;
+        }
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+        return;
+    }
+
+  private:
+
+    void work()
+    {
+        std::size_t seen = 0;
+        while(true)
+        {
+            const std::function<void()>* job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(this->mtx_);
+                this->start_.wait(lock, [this, seen]{
+                    return this->stop_ || this->generation_ != seen;
+                });
+                if(this->stop_) {return;}
+                seen = this->generation_;
+                job  = this->job_;
+            }
+            (*job)(); // exceptions are caught inside the job
+
+            bool is_last = false;
+            {
+                std::lock_guard<std::mutex> lock(this->mtx_);
+                this->running_ -= 1;
+                is_last = (this->running_ == 0);
+            }
+            if(is_last)
+            {
+                this->done_.notify_one();
+            }
+        }
+    }
+
+  private:
+
+    std::size_t                   num_threads_;
+    std::size_t                   generation_;
+    std::size_t                   running_;
+    bool                          stop_;
+    const std::function<void()>*  job_ = nullptr;
+    std::mutex                    mtx_;
+    std::condition_variable       start_;
+    std::condition_variable       done_;
+    std::vector<std::thread>      workers_;
+};
+
+} // jarngreipr
+#endif// JARNGREIPR_UTIL_THREAD_POOL_HPP
@@ -3,8 +3,8 @@
 #include <jarngreipr/xyz/XYZParticle.hpp>
 #include <jarngreipr/xyz/XYZFrame.hpp>
 #include <jarngreipr/util/read_number.hpp>
+#include <jarngreipr/util/gzip.hpp>
 #include <stdexcept>
-#include <fstream>
 #include <sstream>
 
 namespace jarngreipr
@@ -115,7 +115,7 @@ class XYZReader
   private:
     std::size_t line_num_;
     std::string filename_;
-    std::ifstream ifstrm_;
+    igzstream   ifstrm_; // also reads .gz files
     std::vector<frame_type> frames_;
 };
 
@@ -1,16 +1,31 @@
 #include <jarngreipr/forcefield/GoContact.hpp>
+#include <jarngreipr/forcefield/EnsembleGoContact.hpp>
 #include <jarngreipr/forcefield/AICG2Plus.hpp>
 #include <jarngreipr/forcefield/ExcludedVolume.hpp>
 #include <jarngreipr/forcefield/DebyeHuckel.hpp>
+#include <jarngreipr/forcefield/generate_assembly.hpp>
 #include <jarngreipr/format/write_forcefield.hpp>
 #include <jarngreipr/format/write_system.hpp>
 #include <jarngreipr/model/CarbonAlpha.hpp>
 #include <jarngreipr/model/ThreeSPN2.hpp>
 #include <jarngreipr/pdb/PDBReader.hpp>
+#include <jarngreipr/mmcif/MMCIFReader.hpp>
+#include <jarngreipr/model/CGGroupCache.hpp>
+#include <jarngreipr/model/expand_assembly.hpp>
+#include <jarngreipr/model/pack_molecules.hpp>
+#include <jarngreipr/util/hash.hpp>
+#include <jarngreipr/util/output_file.hpp>
 #include <jarngreipr/util/parse_range.hpp>
 #include <algorithm>
+#include <future>
 #include <random>
+#include <thread>
 #include <map>
+#include <set>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <sys/stat.h>
 
 // map of attribute name -> {map of chain ID -> pair of {indices, parameters}}
 template<typename Com, template<typename ...> class Tab,
@@ -29,7 +44,12 @@ read_attributes(const toml::basic_value<Com, Tab, Arr>& group)
     for(const auto& kv : group.as_table())
     {
         const auto& key = kv.first;
-        if(key == "reference" || key == "initial" || key == "model" || key == "chain")
+        if(key == "reference" || key == "initial" || key == "model" || key == "chain" ||
+           key == "reference_model" || key == "initial_model" ||
+           key == "ensemble_models" ||
+           key == "biomt" || key == "symmetry" ||
+           key == "replicate" || key == "replicate_tolerance" ||
+           key == "copies" || key == "min_distance" || key == "seed")
         {
             continue; // these are special keys, not an additional attribute.
         }
@@ -81,33 +101,199 @@ read_attributes(const toml::basic_value<Com, Tab, Arr>& group)
     return attributes;
 }
 
+// several groups often refer to the same pdb file. Readers are shared while
+// the process runs, so a file is parsed only once and the chains read from it
+// are shared among the groups. The file is re-read if it is modified.
+// Files that end with .cif or .mmcif are read as mmCIF. Both formats may be
+// gzip-compressed (.pdb.gz, .cif.gz).
+std::shared_ptr<jarngreipr::StructureReaderBase<double>>
+open_structure_reader(const std::string& pdb_file, const std::size_t num_threads)
+{
+    using namespace jarngreipr;
+    using reader_ptr = std::shared_ptr<StructureReaderBase<double>>;
+    static std::map<std::string, std::pair<std::time_t, reader_ptr>> cache;
+
+    std::string path(pdb_file);
+    if(char* const canonical = ::realpath(pdb_file.c_str(), nullptr))
+    {
+        path = canonical;
+        std::free(canonical);
+    }
+    struct stat st;
+    const std::time_t mtime = (::stat(path.c_str(), &st) == 0) ? st.st_mtime : 0;
+
+    const auto found = cache.find(path);
+    if(found != cache.end() && found->second.first == mtime)
+    {
+        log::info("reusing structures in ", path, '\n');
+        found->second.second->set_num_threads(num_threads);
+        return found->second.second;
+    }
+    const auto ends_with = [](const std::string& str, const std::string& ext) {
+        return ext.size() <= str.size() &&
+               str.compare(str.size() - ext.size(), ext.size(), ext) == 0;
+    };
+    const std::string uncompressed = ends_with(path, ".gz") ?
+        path.substr(0, path.size() - 3) : path;
+    reader_ptr reader;
+    if(ends_with(uncompressed, ".cif") || ends_with(uncompressed, ".mmcif"))
+    {
+        reader = std::make_shared<MMCIFReader<double>>(path, num_threads);
+    }
+    else
+    {
+        reader = std::make_shared<PDBReader<double>>(path, num_threads);
+    }
+    cache[path] = std::make_pair(mtime, reader);
+    return reader;
+}
+
+// operators that make copies of the chains in a group. Either of
+//  1. group.biomt    = 1 # biomolecule number of BIOMT records in `reference`
+//     (all the chains of the group should be in the same "APPLY THE FOLLOWING TO
+//     CHAINS" list)
+//  2. group.symmetry = [{rotation = [[1,0,0],[0,1,0],[0,0,1]], translation = [0,0,0]}, ...]
+// If none is given, it returns an empty vector and the group is not expanded.
+template<typename Com, template<typename ...> class Tab,
+         template<typename ...> class Arr>
+std::vector<jarngreipr::SymmetryOperator<double>>
+read_symmetry_operators(const toml::basic_value<Com, Tab, Arr>& group_def,
+                        const std::string& reference,
+                        const std::vector<std::string>& chain_ids,
+                        const std::size_t num_threads)
+{
+    using namespace jarngreipr;
+    if(group_def.contains("biomt"))
+    {
+        return open_structure_reader(reference, num_threads)->biomt(
+                toml::find<std::int32_t>(group_def, "biomt"), chain_ids);
+    }
+    std::vector<SymmetryOperator<double>> ops;
+    if(!group_def.contains("symmetry")) {return ops;}
+
+    // integers are also accepted, like `[[1, 0, 0], [0, 1, 0], [0, 0, 1]]`.
+    const auto as_real = [](const toml::basic_value<Com, Tab, Arr>& v) -> double {
+        return v.is_integer() ? static_cast<double>(v.as_integer()) :
+                                toml::get<double>(v);
+    };
+    for(const auto& op_def : toml::find(group_def, "symmetry").as_array())
+    {
+        const auto& rotation    = toml::find(op_def, "rotation").as_array();
+        const auto& translation = toml::find(op_def, "translation").as_array();
+        if(rotation.size() != 3 || translation.size() != 3 ||
+           std::any_of(rotation.begin(), rotation.end(),
+               [](const toml::basic_value<Com, Tab, Arr>& row) {
+                   return !row.is_array() || row.as_array().size() != 3;
+               }))
+        {
+            log::error("symmetry: rotation should be a 3x3 matrix and "
+                       "translation should be a 3-vector\n");
+            std::terminate();
+        }
+        SymmetryOperator<double> op;
+        for(std::size_t i=0; i<3; ++i)
+        {
+            for(std::size_t j=0; j<3; ++j)
+            {
+                op.rotation[i][j] = as_real(rotation[i].as_array()[j]);
+            }
+            op.translation[i] = as_real(translation[i]);
+        }
+        ops.push_back(op);
+    }
+    return ops;
+}
+
+// where a coarse-grained group is cached. The cache is not used if the file
+// name is empty.
+struct cg_group_cache_entry
+{
+    std::string   file;
+    std::uint64_t key;
+};
+
+// the key depends on everything that changes the result of coarse-graining.
+cg_group_cache_entry
+make_cg_group_cache_entry(const std::string& cache_dir, const std::string& pdb_file,
+    const std::int32_t pdb_model, const std::vector<std::string>& chain_ids,
+    const std::string& model_name, const std::string& mass_file)
+{
+    using namespace jarngreipr;
+    if(cache_dir.empty()) {return cg_group_cache_entry{"", 0};}
+
+    std::uint64_t key = hash_string("jarngreipr-cg-group-cache-1");
+    {
+        const mapped_file pdb(pdb_file);
+        key = hash_bytes(pdb.data(), pdb.size(), key);
+    }
+    key = hash_string(std::to_string(pdb_model), key);
+    for(const auto& chain_id : chain_ids)
+    {
+        key = hash_string(chain_id, key);
+    }
+    key = hash_string(model_name, key);
+    {
+        const mapped_file mass(mass_file);
+        key = hash_bytes(mass.data(), mass.size(), key);
+    }
+
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(key));
+    std::string file(cache_dir);
+    if(file.back() != '/') {file += '/';}
+    file += buf;
+    file += ".jgcg";
+    return cg_group_cache_entry{file, key};
+}
+
+// `pdb_model` is the serial number of the model to be read. If it is 0, the
+// first model that has the chain is used.
 std::pair<jarngreipr::CGGroup<double>, std::size_t>
 read_cg_group(const std::string& group_name, const std::string& pdb_file,
-    const std::vector<std::string>& chain_ids,
+    const std::int32_t pdb_model, const std::vector<std::string>& chain_ids,
     const std::unique_ptr<jarngreipr::CGModelGeneratorBase<double>>& model,
     const std::map<std::string, std::map<std::string,
             std::vector<std::pair<std::int64_t, std::string>>>>& attributes,
-    std::size_t offset)
+    std::size_t offset, const std::size_t num_threads,
+    const cg_group_cache_entry& cache)
 {
     using namespace jarngreipr;
-    PDBReader<double> reader(pdb_file);
 
     // -------------------------------------------------------------------
     // Coarse-Graining
 
     CGGroup<double> group(group_name);
-    for(const auto& chain_id : chain_ids)
+    if(!cache.file.empty() &&
+       read_cg_group_cache(cache.file, cache.key, group, offset))
     {
-        if(chain_id.size() != 1)
+        log::info("group ", group_name, " is loaded from ", cache.file, '\n');
+    }
+    else
+    {
+        const auto reader = open_structure_reader(pdb_file, num_threads);
+        std::size_t bead_offset = offset;
+        for(const auto& chain_id : chain_ids)
         {
-            log::error("chain ID should be 1 letter -> ", chain_id, '\n');
-            std::terminate();
-        }
-        log::info("reading chain ", chain_id, " of group ", group_name, '\n');
+            log::info("reading chain ", chain_id, " of group ", group_name, '\n');
 
-        const auto chain = reader.read_chain(chain_id.front());
-        auto cg_chain = model->generate(chain, offset);
+            // beads refer to the atoms in the chain. it is kept alive by them.
+            const auto chain = (pdb_model == 0) ? reader->read_chain(chain_id) :
+                                   reader->read_chain(chain_id, pdb_model);
+            group.push_back(model->generate(chain, bead_offset));
+            bead_offset += group.back().size();
+        }
+        if(!cache.file.empty() &&
+           write_cg_group_cache(cache.file, cache.key, group, offset))
+        {
+            log::info("group ", group_name, " is cached in ", cache.file, '\n');
+        }
+    }
 
+    // attributes depend on the input, so they are not cached.
+    for(std::size_t i=0; i<group.size(); ++i)
+    {
+        const auto& chain_id = chain_ids.at(i);
+        const auto& cg_chain = group.at(i);
         for(const auto& attribute : attributes)
         {
             const auto& attr_name = attribute.first;
@@ -116,7 +302,7 @@ read_cg_group(const std::string& group_name, const std::string& pdb_file,
                 const auto& regions = attribute.second.at(chain_id);
                 for(auto& cg_bead : cg_chain)
                 {
-                    const auto resID = cg_bead->atoms().front().residue_id;
+                    const auto resID = cg_bead->residue_id();
                     const auto found = std::find_if(
                         regions.begin(), regions.end(),
                         [=](const std::pair<std::int64_t, std::string>& x){
@@ -132,26 +318,30 @@ read_cg_group(const std::string& group_name, const std::string& pdb_file,
                 }
             }
         }
-        group.push_back(cg_chain);
-        offset += group.back().size();
+        offset += cg_chain.size();
     }
     return std::make_pair(group, offset);
 }
 
 std::unique_ptr<jarngreipr::ForceFieldGenerator<double>>
 setup_forcefield_generator(const std::string& forcefield,
-                           const std::string& parameter_file)
+                           const std::string& parameter_file,
+                           const std::size_t  num_threads)
 {
     using namespace jarngreipr;
     if(forcefield == "AICG2+")
     {
-        return std::unique_ptr<ForceFieldGenerator<double>>(
+        std::unique_ptr<ForceFieldGenerator<double>> ffgen(
             new AICG2Plus<double>(toml::parse(parameter_file)));
+        ffgen->set_num_threads(num_threads);
+        return ffgen;
     }
     else if(forcefield == "GoContact")
     {
-        return std::unique_ptr<ForceFieldGenerator<double>>(
+        std::unique_ptr<ForceFieldGenerator<double>> ffgen(
             new GoContact<double>(toml::parse(parameter_file)));
+        ffgen->set_num_threads(num_threads);
+        return ffgen;
     }
     else if(forcefield == "ExcludedVolume")
     {
@@ -196,7 +386,13 @@ setup_model_generator(const std::string& model, const toml::value& params)
     }
 }
 
-std::string read_input_filename(int argc, char **argv)
+// read options. the number of threads is written to `num_threads`, the
+// directory to cache coarse-grained groups is written to `cache_dir`,
+// `to_stdout` becomes true if the output should be written to stdout, and
+// `split_forcefield` becomes true if each forcefield table has its own file.
+std::string read_input_filename(int argc, char **argv, std::size_t& num_threads,
+                                std::string& cache_dir, bool& to_stdout,
+                                bool& split_forcefield)
 {
     using namespace jarngreipr;
     std::vector<std::string> opts;
@@ -212,12 +408,47 @@ std::string read_input_filename(int argc, char **argv)
     log::logger::activate(log::level::error);
 
     std::string fname;
-    for(const auto& opt : opts)
+    for(std::size_t i=0; i<opts.size(); ++i)
     {
+        const auto& opt = opts.at(i);
         if(opt == "--debug")
         {
             log::logger::activate(log::level::debug);
         }
+        else if(opt == "--threads")
+        {
+            // --threads 0 uses all the hardware threads
+            if(i+1 == opts.size() || opts.at(i+1).empty() ||
+               opts.at(i+1).find_first_not_of("0123456789") != std::string::npos)
+            {
+                log::error("--threads requires the number of threads\n");
+                std::terminate();
+            }
+            num_threads = std::stoul(opts.at(++i));
+            if(num_threads == 0)
+            {
+                num_threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            log::info("using ", num_threads, " threads\n");
+        }
+        else if(opt == "--stdout")
+        {
+            to_stdout = true;
+        }
+        else if(opt == "--split-forcefield")
+        {
+            split_forcefield = true;
+        }
+        else if(opt == "--cache")
+        {
+            if(i+1 == opts.size() || opts.at(i+1).empty())
+            {
+                log::error("--cache requires a directory\n");
+                std::terminate();
+            }
+            cache_dir = opts.at(++i);
+            log::info("caching coarse-grained groups in ", cache_dir, '\n');
+        }
         else if(5 < opt.size() && opt.substr(opt.size()-5, 5) == ".toml")
         {
             fname = opt;
@@ -236,23 +467,46 @@ int main(int argc, char **argv)
 
     if(argc < 2)
     {
-        log::error("Usage: jarngreipr input.toml\n");
+        log::error("Usage: jarngreipr [--threads N] [--cache DIR] [--stdout] "
+                   "[--split-forcefield] input.toml\n");
         return 1;
     }
 
-    const std::string fname = read_input_filename(argc, argv);
+    std::size_t num_threads = 1;
+    std::string cache_dir;
+    bool        to_stdout        = false;
+    bool        split_forcefield = false;
+    const std::string fname = read_input_filename(argc, argv, num_threads,
+            cache_dir, to_stdout, split_forcefield);
+    if(to_stdout && split_forcefield)
+    {
+        log::warn("--split-forcefield is ignored when --stdout is given\n");
+    }
     const auto input  = toml::parse<toml::discard_comments, std::map>(fname);
 
-    // output files and units tables
+    // The simulator, the system and the forcefields are written to
+    // `{path}/{prefix}_simulator.toml` and so on, and `{path}/{prefix}.toml`
+    // refers to them. With `--split-forcefield`, each forcefield table has its
+    // own file. With `--stdout`, all of them are written to stdout.
+    const auto& output = toml::find(input, "files", "output");
+    auto output_path   = toml::find<std::string>(output, "path");
+    if(output_path.empty() || output_path.back() != '/') {output_path += '/';}
+    const auto file_prefix   = toml::find<std::string>(output, "prefix");
+    const auto output_prefix = output_path + file_prefix;
+
+    // output files and units tables. The file that refers to the others is
+    // written after the forcefields are generated.
+    if(to_stdout)
     {
         std::cout << "[files.output]\n";
-        std::cout << toml::find(input, "files", "output") << std::endl;
+        std::cout << output                     << '\n';
         std::cout << "[units]\n";
-        std::cout << toml::find(input, "units")           << std::endl;
+        std::cout << toml::find(input, "units") << '\n';
     }
 
     // TODO be aware of paths
-    const auto mass_params = toml::parse("parameter/mass.toml");
+    const std::string mass_file("parameter/mass.toml");
+    const auto mass_params = toml::parse(mass_file);
 
     // get `path.pdb`. if not exists, return "./"
     const auto pdb_path = [&]() -> std::string {
@@ -277,6 +531,10 @@ int main(int argc, char **argv)
     std::size_t offset = 0; // for bead index
     std::map<std::string, CGGroup<double>> groups;
     std::map<std::string, CGGroup<double>> initials;
+    std::map<std::string, std::size_t>     assembly_copies; // group -> copies
+    std::map<std::string, double>          replicate_tolerance;
+    std::map<std::string, std::vector<CGGroup<double>>> ensembles; // models
+    std::set<std::string>                  packed_groups; // placed randomly
     for(const auto& kv : system.as_table())
     {
         // special keys. skip them.
@@ -285,9 +543,9 @@ int main(int argc, char **argv)
 
         const auto& group_def = kv.second;
 
+        const auto model_name = toml::find<std::string>(group_def, "model");
         const auto model_generator = setup_model_generator(
-                toml::find<std::string>(group_def, "model"),
-                toml::find(mass_params, "mass"));
+                model_name, toml::find(mass_params, "mass"));
 
         // --------------------------------------------------------------------
         // Extract chains to be coarse-grained. All of the following are valid.
@@ -295,6 +553,7 @@ int main(int argc, char **argv)
         //  2. proteins.chain = "A:D"
         //  3. proteins.chain = ["A", "B"]
         //  4. proteins.chain = ["A:B", "E:F", "H"]
+        //  5. proteins.chain = ["AA", "AB"] (multi-letter IDs of mmCIF)
         std::vector<std::string> chain_ids;
         if(group_def.at("chain").is_string())
         {
@@ -311,30 +570,134 @@ int main(int argc, char **argv)
                 }
             }
         }
+        if(chain_ids.empty())
+        {
+            log::error("group ", kv.first, " has no valid chain ID\n");
+            std::terminate();
+        }
 
         // attributes of beads; like flexible regions
         const auto attributes = read_attributes(group_def);
 
         // group and the next offset
-        auto group_ofs = read_cg_group(kv.first,
-            pdb_path + toml::find<std::string>(group_def, "reference"), chain_ids,
-            model_generator, attributes, offset);
+        // a model of an ensemble can be chosen by its serial number.
+        const auto reference = pdb_path + toml::find<std::string>(group_def, "reference");
+        const auto reference_model =
+            toml::find_or<std::int32_t>(group_def, "reference_model", 0);
+        auto group_ofs = read_cg_group(kv.first, reference, reference_model,
+            chain_ids, model_generator, attributes, offset, num_threads,
+            make_cg_group_cache_entry(cache_dir, reference, reference_model,
+                                      chain_ids, model_name, mass_file));
+
+        // the initial structure is read here so that randomly placed copies
+        // can be checked against it.
+        const bool has_initial = group_def.as_table().count("initial") != 0;
+        std::pair<jarngreipr::CGGroup<double>, std::size_t> init_ofs;
+        if(has_initial)
+        {
+            const auto initial = pdb_path + toml::find<std::string>(group_def, "initial");
+            const auto initial_model =
+                toml::find_or<std::int32_t>(group_def, "initial_model", 0);
+            init_ofs = read_cg_group(kv.first, initial, initial_model,
+                chain_ids, model_generator, attributes, offset, num_threads,
+                make_cg_group_cache_entry(cache_dir, initial, initial_model,
+                                          chain_ids, model_name, mass_file));
+            if(init_ofs.second != group_ofs.second)
+            {
+                log::error("the initial and the reference structure "
+                    "in a group ", kv.first, " differs each other\n");
+                std::terminate();
+            }
+        }
+
+        // a symmetric assembly is made from one coarse-grained unit.
+        auto operators = read_symmetry_operators(group_def, reference,
+                                                 chain_ids, num_threads);
 
+        // `copies` copies of the unit are placed randomly in the periodic box,
+        // e.g. crowders. Overlaps are checked on the initial structure if any,
+        // because its coordinates are written to the system. The reference
+        // copies are moved in the same way; only their intra-copy parameters
+        // are generated, so their positions do not matter.
+        if(group_def.contains("copies"))
+        {
+            const auto& boundary = toml::find(system, "boundary_shape");
+            if(!operators.empty() || !boundary.contains("lower") ||
+               !boundary.contains("upper"))
+            {
+                log::error("group ", kv.first, ": `copies` requires a periodic "
+                    "boundary_shape and cannot be used with biomt or symmetry\n");
+                std::terminate();
+            }
+            const auto lower = toml::find<std::array<double, 3>>(boundary, "lower");
+            const auto upper = toml::find<std::array<double, 3>>(boundary, "upper");
+            std::mt19937 rng(toml::find_or<std::uint32_t>(group_def, "seed", 123456789));
+            operators = pack_molecules(has_initial ? init_ofs.first : group_ofs.first,
+                toml::find<std::size_t>(group_def, "copies"),
+                mjolnir::math::Vector<double, 3>(lower[0], lower[1], lower[2]),
+                mjolnir::math::Vector<double, 3>(upper[0], upper[1], upper[2]),
+                toml::find_or<double>(group_def, "min_distance", 4.0), rng);
+            packed_groups.insert(kv.first);
+        }
+        if(!operators.empty())
+        {
+            log::info("group ", kv.first, " has ", operators.size(), " copies\n");
+            group_ofs.first  = expand_assembly(group_ofs.first, operators);
+            group_ofs.second = offset + operators.size() * (group_ofs.second - offset);
+            assembly_copies[kv.first] = operators.size();
+        }
         groups[kv.first] = std::move(group_ofs.first);
 
-        if(group_def.as_table().count("initial") != 0)
+        // models of an ensemble, e.g. NMR, for EnsembleGoContact. They have
+        // the same bead indices as the reference.
+        if(group_def.contains("ensemble_models"))
         {
-            auto init_ofs = read_cg_group(kv.first,
-                pdb_path + toml::find<std::string>(group_def, "initial"), chain_ids,
-                model_generator, attributes, offset);
-            initials[kv.first] = std::move(init_ofs.first);
+            if(!operators.empty())
+            {
+                log::error("group ", kv.first, ": `ensemble_models` cannot be "
+                    "used with biomt, symmetry or copies\n");
+                std::terminate();
+            }
+            auto& models = ensembles[kv.first];
+            for(const auto model : toml::find<std::vector<std::int32_t>>(
+                        group_def, "ensemble_models"))
+            {
+                auto model_ofs = read_cg_group(kv.first, reference, model,
+                    chain_ids, model_generator, attributes, offset, num_threads,
+                    make_cg_group_cache_entry(cache_dir, reference, model,
+                                              chain_ids, model_name, mass_file));
+                if(model_ofs.second != group_ofs.second)
+                {
+                    log::error("model ", model, " of the ensemble in a group ",
+                        kv.first, " differs from the reference structure\n");
+                    std::terminate();
+                }
+                models.push_back(std::move(model_ofs.first));
+            }
+        }
 
-            if(init_ofs.second != group_ofs.second)
+        // identical chains share intra-chain parameters. By default, the
+        // tolerance of coordinates is 10 times the precision of pdb files
+        // so that the rounding errors of copied chains are allowed.
+        if(toml::find_or<bool>(group_def, "replicate", false))
+        {
+            if(!operators.empty())
             {
-                log::error("the initial and the reference structure "
-                    "in a group ", kv.first, " differs each other\n");
+                log::error("group ", kv.first, ": `replicate` cannot be "
+                    "used with biomt, symmetry or copies\n");
                 std::terminate();
             }
+            replicate_tolerance[kv.first] =
+                toml::find_or<double>(group_def, "replicate_tolerance", 1e-2);
+        }
+
+        if(has_initial)
+        {
+            if(!operators.empty())
+            {
+                init_ofs.first = expand_assembly(init_ofs.first, operators);
+            }
+            initials[kv.first] = std::move(init_ofs.first);
         }
         else
         {
@@ -346,47 +709,57 @@ int main(int argc, char **argv)
 
     // ========================================================================
 
-    std::random_device rng;
-    std::cout << "[simulator]\n";
-    std::cout << "type                  = \"MolecularDynamics\"\n";
-    std::cout << "boundary_type         = \"Unlimited\"\n";
-    std::cout << "precision             = \"double\"\n";
-    std::cout << "delta_t               = 0.1\n";
-    std::cout << "total_step            = 1000_000\n";
-    std::cout << "save_step             =    1_000\n";
-    std::cout << "seed                  = " << rng() << '\n';
-    std::cout << "integrator.type       = \"BAOABLangevin\"\n";
-    std::cout << "integrator.parameters = [\n";
-    {
-        std::size_t num_total_bead = 0;
-        for(const auto& kv : groups)
+    // the simulator and the system are written while forcefield parameters
+    // are being generated.
+    const auto write_simulator_section = [&](std::ostream& os) -> void {
+        std::random_device rng;
+        os << "[simulator]\n";
+        os << "type                  = \"MolecularDynamics\"\n";
+        if(toml::find(system, "boundary_shape").contains("lower"))
         {
-            const auto& group = kv.second;
-            for(const auto& chain : group)
+            os << "boundary_type         = \"PeriodicCuboid\"\n";
+        }
+        else
+        {
+            os << "boundary_type         = \"Unlimited\"\n";
+        }
+        os << "precision             = \"double\"\n";
+        os << "delta_t               = 0.1\n";
+        os << "total_step            = 1000_000\n";
+        os << "save_step             =    1_000\n";
+        os << "seed                  = " << rng() << '\n';
+        os << "integrator.type       = \"BAOABLangevin\"\n";
+        os << "integrator.parameters = [\n";
+        {
+            std::size_t num_total_bead = 0;
+            for(const auto& kv : groups)
             {
-                num_total_bead += chain.size();
+                const auto& group = kv.second;
+                for(const auto& chain : group)
+                {
+                    num_total_bead += chain.size();
+                }
             }
-        }
 
-        const auto width = std::to_string(num_total_bead).size();
-        for(const auto& kv : groups)
-        {
-            const auto& group = kv.second;
-            for(const auto& chain : group)
+            const auto width = std::to_string(num_total_bead).size();
+            for(const auto& kv : groups)
             {
-                for(const auto& bead : chain)
+                const auto& group = kv.second;
+                for(const auto& chain : group)
                 {
-                    std::cout << "{index = " << std::setw(width) << bead->index()
-                              << ", gamma = " << 168.7 * 0.005 / bead->mass() << "},\n";
+                    for(const auto& bead : chain)
+                    {
+                        os << "{index = " << std::setw(width) << bead->index()
+                           << ", gamma = " << 168.7 * 0.005 / bead->mass() << "},\n";
+                    }
                 }
             }
+            os << "]\n";
         }
-        std::cout << "]\n";
-    }
+        return;
+    };
 
-    // ========================================================================
-    // generate system
-    {
+    const auto write_system_section = [&](std::ostream& os) -> void {
         using value_type = toml::basic_value<toml::preserve_comments, std::map>;
         using table_type = typename value_type::table_type;
         using array_type = typename value_type::array_type;
@@ -426,15 +799,32 @@ int main(int argc, char **argv)
                 }
             }
         }
-        write_system(std::cout, sys);
+        write_system(os, sys);
+        return;
+    };
 
-        log::info("[[systems]] written\n");
+    std::future<void> simulator_written, system_written;
+    if(to_stdout)
+    {
+        write_simulator_section(std::cout);
+        write_system_section(std::cout);
+    }
+    else
+    {
+        simulator_written = std::async(std::launch::async, [&]() -> void {
+            output_file ofs(output_prefix + "_simulator.toml");
+            write_simulator_section(ofs);
+        });
+        system_written = std::async(std::launch::async, [&]() -> void {
+            output_file ofs(output_prefix + "_system.toml");
+            write_system_section(ofs);
+        });
     }
 
     // ========================================================================
     // generate forcefield parameters
 
-    toml::basic_value<toml::preserve_comments, std::map> ff;
+    ForceField<double> ff;
     const auto forcefield = toml::find_or(
             input, "forcefields", toml::value{toml::table{}}).as_array().front();
 
@@ -449,12 +839,44 @@ int main(int argc, char **argv)
             const auto para_file = toml::find_or<std::string>(
                     local, "parameter_file", "parameter/" + ff_name + ".toml");
 
-            const auto ffgen = setup_forcefield_generator(ff_name, para_file);
+            // it needs all the models of a group, not only the reference.
+            if(ff_name == "EnsembleGoContact")
+            {
+                const EnsembleGoContact<double> ffgen(
+                        toml::parse(para_file), num_threads);
+                for(auto gname : toml::find<std::vector<std::string>>(local, "groups"))
+                {
+                    if(ensembles.count(gname) == 0)
+                    {
+                        log::error("EnsembleGoContact: group ", gname,
+                                   " does not have `ensemble_models`\n");
+                        std::terminate();
+                    }
+                    ffgen.generate(ff, groups.at(gname),
+                        std::vector<std::reference_wrapper<const CGGroup<double>>>(
+                            ensembles.at(gname).begin(), ensembles.at(gname).end()));
+                }
+                continue;
+            }
+
+            const auto ffgen = setup_forcefield_generator(ff_name, para_file, num_threads);
 
             for(auto gname : toml::find<std::vector<std::string>>(local, "groups"))
             {
                 const auto& group = groups.at(gname);
-                ffgen->generate(ff, group);
+                if(assembly_copies.count(gname) != 0)
+                {
+                    generate_assembly(*ffgen, ff, group, assembly_copies.at(gname),
+                                      /* inter_copy = */ packed_groups.count(gname) == 0);
+                }
+                else if(replicate_tolerance.count(gname) != 0)
+                {
+                    generate_replicated(*ffgen, ff, group, replicate_tolerance.at(gname));
+                }
+                else
+                {
+                    ffgen->generate(ff, group);
+                }
             }
         }
     }
@@ -471,7 +893,7 @@ int main(int argc, char **argv)
                     global, "parameter_file", "parameter/" + ff_name + ".toml");
             log::debug("generating ", ff_name, "\n");
 
-            const auto ffgen = setup_forcefield_generator(ff_name, para_file);
+            const auto ffgen = setup_forcefield_generator(ff_name, para_file, num_threads);
 
             std::vector<std::reference_wrapper<const CGGroup<double>>> cg_groups;
             for(auto gname : toml::find<std::vector<std::string>>(global, "groups"))
@@ -486,7 +908,39 @@ int main(int argc, char **argv)
     }
 
     log::info("writing forcefields\n");
-    write_forcefield(std::cout, ff);
+    if(to_stdout)
+    {
+        write_forcefield(std::cout, ff);
+    }
+    else
+    {
+        output_file ofs(output_prefix + ".toml");
+        ofs << "[files.output]\n";
+        ofs << output                     << '\n';
+        ofs << "[files.input]\n";
+        ofs << "path = " << toml::value(output_path) << '\n';
+        ofs << "[units]\n";
+        ofs << toml::find(input, "units") << '\n';
+        ofs << "[simulator]\n";
+        ofs << "file_name = " << toml::value(file_prefix + "_simulator.toml") << '\n';
+        ofs << "[[systems]]\n";
+        ofs << "file_name = " << toml::value(file_prefix + "_system.toml")    << '\n';
+        if(split_forcefield)
+        {
+            write_forcefield_files(ofs, ff, output_path, file_prefix, num_threads);
+        }
+        else
+        {
+            ofs << "[[forcefields]]\n";
+            ofs << "file_name = " << toml::value(file_prefix + "_forcefield.toml") << '\n';
+
+            output_file ff_file(output_prefix + "_forcefield.toml");
+            write_forcefield(ff_file, ff);
+        }
+        simulator_written.get();
+        system_written.get();
+    }
+    log::info("[simulator], [[systems]] and [[forcefields]] written\n");
 
     return 0;
 }
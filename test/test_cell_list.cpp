@@ -0,0 +1,140 @@
+#define BOOST_TEST_MODULE "test_cell_list"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/geometry/CellList.hpp>
+#include <jarngreipr/geometry/distance.hpp>
+#include <jarngreipr/forcefield/inter_chain_contacts.hpp>
+#include <random>
+
+BOOST_AUTO_TEST_CASE(test_cell_list_contains_all_the_neighbors)
+{
+    using coordinate_type = jarngreipr::CellList<double>::coordinate_type;
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<double> uni(-20.0, 20.0);
+
+    // 100 owners, each has 5 points
+    const double cutoff = 6.5;
+    std::vector<std::vector<coordinate_type>> owners(100);
+    jarngreipr::CellList<double> cell_list(cutoff);
+    for(std::size_t i=0; i<owners.size(); ++i)
+    {
+        for(std::size_t j=0; j<5; ++j)
+        {
+            const coordinate_type pos(uni(mt), uni(mt), uni(mt));
+            owners.at(i).push_back(pos);
+            cell_list.add(i, pos);
+        }
+    }
+    cell_list.make();
+
+    for(std::size_t i=0; i<owners.size(); ++i)
+    {
+        const auto neighbors = cell_list.neighbors(i);
+        BOOST_TEST(std::is_sorted(neighbors.begin(), neighbors.end()));
+        BOOST_TEST(std::count(neighbors.begin(), neighbors.end(), i) == 1);
+
+        for(std::size_t j=0; j<owners.size(); ++j)
+        {
+            bool within = false;
+            for(const auto& p1 : owners.at(i))
+            {
+                for(const auto& p2 : owners.at(j))
+                {
+                    within = within ||
+                        (jarngreipr::distance_sq(p1, p2) < cutoff * cutoff);
+                }
+            }
+            if(within)
+            {
+                BOOST_TEST(std::count(neighbors.begin(), neighbors.end(), j) == 1);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_cell_list_owner_without_points)
+{
+    using coordinate_type = jarngreipr::CellList<double>::coordinate_type;
+
+    jarngreipr::CellList<double> cell_list(5.0);
+    cell_list.add(0, coordinate_type(0.0, 0.0, 0.0));
+    cell_list.add(2, coordinate_type(1.0, 0.0, 0.0));
+    cell_list.make();
+
+    BOOST_TEST(cell_list.neighbors(1).empty());
+    BOOST_TEST(cell_list.neighbors(0).size() == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(test_inter_chain_contacts_same_as_nested_loops)
+{
+    using coordinate_type = jarngreipr::CellList<double>::coordinate_type;
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<double> uni(-20.0, 20.0);
+
+    // an empty chain in the middle and a pair of chains that is skipped
+    const double cutoff = 6.5;
+    const std::vector<std::size_t> sizes{10, 0, 30, 25, 35};
+    std::vector<std::size_t> chain_offsets(1, 0);
+    std::vector<coordinate_type> points;
+    jarngreipr::CellList<double> cell_list(cutoff);
+    for(const auto size : sizes)
+    {
+        for(std::size_t k=0; k<size; ++k)
+        {
+            points.emplace_back(uni(mt), uni(mt), uni(mt));
+            cell_list.add(points.size() - 1, points.back());
+        }
+        chain_offsets.push_back(points.size());
+    }
+    cell_list.make();
+
+    const auto is_partner = [](const std::size_t c1, const std::size_t c2) {
+        return !(c1 == 0 && c2 == 3);
+    };
+    const auto contact = [&](const std::size_t c1, const std::size_t k1,
+                             const std::size_t c2, const std::size_t k2) {
+        const auto d = jarngreipr::distance(points.at(chain_offsets.at(c1) + k1),
+                                            points.at(chain_offsets.at(c2) + k2));
+        return std::make_pair(d < cutoff, d);
+    };
+
+    jarngreipr::ThreadPool pool(3);
+    const auto found = jarngreipr::find_inter_chain_contacts(
+            pool, cell_list, chain_offsets, is_partner, contact);
+    BOOST_TEST_REQUIRE(found.size() == sizes.size());
+
+    for(std::size_t c1=0; c1<sizes.size(); ++c1)
+    {
+        std::vector<jarngreipr::InterChainContact<double>> expected;
+        for(std::size_t c2=c1+1; c2<sizes.size(); ++c2)
+        {
+            if(!is_partner(c1, c2)) {continue;}
+            for(std::size_t k1=0; k1<sizes.at(c1); ++k1)
+            {
+                for(std::size_t k2=0; k2<sizes.at(c2); ++k2)
+                {
+                    const auto c = contact(c1, k1, c2, k2);
+                    if(c.first) {expected.push_back({c2, k1, k2, c.second});}
+                }
+            }
+        }
+        BOOST_TEST_REQUIRE(found.at(c1).size() == expected.size());
+        for(std::size_t i=0; i<expected.size(); ++i)
+        {
+            BOOST_TEST(found.at(c1).at(i).partner == expected.at(i).partner);
+            BOOST_TEST(found.at(c1).at(i).first   == expected.at(i).first);
+            BOOST_TEST(found.at(c1).at(i).second  == expected.at(i).second);
+            BOOST_TEST(found.at(c1).at(i).coef    == expected.at(i).coef);
+        }
+        for(std::size_t c2=0; c2<sizes.size(); ++c2)
+        {
+            const auto range = jarngreipr::contacts_with(found.at(c1), c2);
+            BOOST_TEST(std::distance(range.first, range.second) == std::count_if(
+                expected.begin(), expected.end(),
+                [c2](const jarngreipr::InterChainContact<double>& c) {
+                    return c.partner == c2;
+                }));
+        }
+    }
+}
@@ -0,0 +1,161 @@
+#define BOOST_TEST_MODULE "test_cg_group_cache"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/model/CGGroupCache.hpp>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+
+namespace
+{
+using bead_type       = jarngreipr::CachedBead<double>;
+using coordinate_type = bead_type::coordinate_type;
+
+// chain A has 3 amino acids, chain B has 3 nucleotide beads.
+// bead k has index `offset + k` and k+1 heavy atoms.
+jarngreipr::CGGroup<double> make_group(const std::size_t offset)
+{
+    const jarngreipr::CGBeadKind kinds[] = {
+        jarngreipr::CGBeadKind::CarbonAlpha, jarngreipr::CGBeadKind::CarbonAlpha,
+        jarngreipr::CGBeadKind::CarbonAlpha, jarngreipr::CGBeadKind::ThreeSPN2Phosphate,
+        jarngreipr::CGBeadKind::ThreeSPN2Sugar, jarngreipr::CGBeadKind::ThreeSPN2Base
+    };
+    const char* names[] = {"ALA", "GLY", "LYS", "P", "S", "A"};
+
+    jarngreipr::CGGroup<double> group("test");
+    for(std::size_t c=0; c<2; ++c)
+    {
+        jarngreipr::CGChain<double> chain(c == 0 ? "A" : "B");
+        for(std::size_t i=0; i<3; ++i)
+        {
+            const std::size_t k = c * 3 + i;
+            std::vector<coordinate_type> heavy;
+            std::vector<std::uint8_t>    classes;
+            for(std::size_t j=0; j<=k; ++j)
+            {
+                heavy.emplace_back(1.0 * k, 0.5 * j, -0.25 * j);
+                classes.push_back(static_cast<std::uint8_t>(k * 16 + j));
+            }
+            chain.push_back(std::make_shared<bead_type>(kinds[k], offset + k,
+                10.0 + k, names[k], coordinate_type(k, 2.0 * k, 3.0 * k),
+                static_cast<std::int32_t>(i + 1), heavy, classes));
+        }
+        group.push_back(std::move(chain));
+    }
+    return group;
+}
+
+std::string read_file(const std::string& fname)
+{
+    std::ifstream ifs(fname, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs),
+                       std::istreambuf_iterator<char>());
+}
+void write_file(const std::string& fname, const std::string& content)
+{
+    std::ofstream ofs(fname, std::ios::binary);
+    ofs.write(content.data(), content.size());
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_cg_group_cache_round_trip)
+{
+    const std::string fname("test_cg_group_cache_round_trip.bin");
+    const auto original = make_group(100);
+    BOOST_TEST_REQUIRE(jarngreipr::write_cg_group_cache(fname, 42, original, 100));
+
+    // the loaded group is placed at another offset
+    jarngreipr::CGGroup<double> loaded("test");
+    BOOST_TEST_REQUIRE(jarngreipr::read_cg_group_cache(fname, 42, loaded, 500));
+    BOOST_TEST_REQUIRE(loaded.size() == original.size());
+    for(std::size_t c=0; c<original.size(); ++c)
+    {
+        const auto& lhs = original.at(c);
+        const auto& rhs = loaded.at(c);
+        BOOST_TEST(lhs.name() == rhs.name());
+        BOOST_TEST_REQUIRE(lhs.size() == rhs.size());
+        for(std::size_t i=0; i<lhs.size(); ++i)
+        {
+            const auto& l = lhs.at(i);
+            const auto& r = rhs.at(i);
+            BOOST_TEST((l->kind() == r->kind()));
+            BOOST_TEST(l->index() + 400 == r->index());
+            BOOST_TEST(l->mass()       == r->mass());
+            BOOST_TEST(l->name()       == r->name());
+            BOOST_TEST(l->residue_id() == r->residue_id());
+            for(std::size_t d=0; d<3; ++d)
+            {
+                BOOST_TEST(l->position()[d] == r->position()[d]);
+            }
+            BOOST_TEST_REQUIRE(l->heavy_positions().size() ==
+                               r->heavy_positions().size());
+            for(std::size_t j=0; j<l->heavy_positions().size(); ++j)
+            {
+                for(std::size_t d=0; d<3; ++d)
+                {
+                    BOOST_TEST(l->heavy_positions().at(j)[d] ==
+                               r->heavy_positions().at(j)[d]);
+                }
+            }
+            BOOST_TEST(l->heavy_atom_classes() == r->heavy_atom_classes(),
+                       boost::test_tools::per_element());
+        }
+    }
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_cg_group_cache_rejects_broken_files)
+{
+    const std::string fname("test_cg_group_cache_broken.bin");
+    BOOST_TEST_REQUIRE(jarngreipr::write_cg_group_cache(fname, 42, make_group(0), 0));
+    const std::string content = read_file(fname);
+
+    // a group that fails to load is not modified
+    jarngreipr::CGGroup<double> group("test");
+    const auto check_rejected = [&](const std::uint64_t key) {
+        BOOST_TEST(!jarngreipr::read_cg_group_cache(fname, key, group, 0));
+        BOOST_TEST(group.size() == 0u);
+    };
+
+    // the inputs have been changed
+    check_rejected(43);
+
+    // truncated at various positions
+    for(const std::size_t len : {std::size_t(4), std::size_t(20),
+            content.size() / 2, content.size() - 1})
+    {
+        write_file(fname, content.substr(0, len));
+        check_rejected(42);
+    }
+
+    // a trailing garbage
+    write_file(fname, content + '\0');
+    check_rejected(42);
+
+    // not a cache file
+    std::string bad_magic = content;
+    bad_magic.at(0) = 'X';
+    write_file(fname, bad_magic);
+    check_rejected(42);
+
+    // the kind of the first bead is out of range. It follows the header
+    // (magic, byte order, size of real, key, number of chains), the name of
+    // the first chain, and the number of beads.
+    std::string bad_kind = content;
+    bad_kind.at(8 + 4 + 4 + 8 + 8 + (8 + 1) + 8) = 4;
+    write_file(fname, bad_kind);
+    check_rejected(42);
+
+    // the original file is still valid
+    write_file(fname, content);
+    BOOST_TEST(jarngreipr::read_cg_group_cache(fname, 42, group, 0));
+    BOOST_TEST(group.size() == 2u);
+
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_cg_group_cache_missing_file)
+{
+    jarngreipr::CGGroup<double> group("test");
+    BOOST_TEST(!jarngreipr::read_cg_group_cache(
+                "test_cg_group_cache_not_exist.bin", 42, group, 0));
+}
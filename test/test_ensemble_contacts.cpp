@@ -0,0 +1,108 @@
+#define BOOST_TEST_MODULE "test_ensemble_contacts"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/forcefield/ensemble_contacts.hpp>
+#include <jarngreipr/forcefield/EnsembleGoContact.hpp>
+#include <jarngreipr/model/CachedBead.hpp>
+
+namespace
+{
+// a chain of 4 beads on the x axis. each bead has one heavy atom.
+jarngreipr::CGGroup<double> make_model(const std::string& name, const double dx)
+{
+    using bead_type       = jarngreipr::CachedBead<double>;
+    using coordinate_type = bead_type::coordinate_type;
+
+    jarngreipr::CGChain<double> chain("A");
+    for(std::size_t i=0; i<4; ++i)
+    {
+        const coordinate_type pos(i * dx, 0.0, 0.0);
+        chain.push_back(std::make_shared<bead_type>(jarngreipr::CGBeadKind::CarbonAlpha,
+            10 + i, 1.0, "CA", pos, static_cast<std::int32_t>(i + 1),
+            std::vector<coordinate_type>{pos}, std::vector<std::uint8_t>{0}));
+    }
+    jarngreipr::CGGroup<double> group(name);
+    group.push_back(std::move(chain));
+    return group;
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_ensemble_contacts_frequency)
+{
+    // in the compact model, all the pairs are within 5.0. in the extended
+    // model, no pair is.
+    const auto compact  = make_model("compact",  1.0);
+    const auto extended = make_model("extended", 10.0);
+    const std::vector<std::reference_wrapper<const jarngreipr::CGGroup<double>>>
+        models{std::cref(compact), std::cref(compact), std::cref(extended),
+               std::cref(compact)};
+
+    for(const std::size_t num_threads : {1, 4})
+    {
+        // pairs closer than 2 in the sequence are ignored.
+        const auto contacts =
+            jarngreipr::ensemble_contacts(models, 5.0, 2, num_threads);
+        BOOST_TEST_REQUIRE(contacts.size() == 3u);
+
+        BOOST_TEST(contacts.at(0).index1 == 10u);
+        BOOST_TEST(contacts.at(0).index2 == 12u);
+        BOOST_TEST(contacts.at(1).index1 == 10u);
+        BOOST_TEST(contacts.at(1).index2 == 13u);
+        BOOST_TEST(contacts.at(2).index1 == 11u);
+        BOOST_TEST(contacts.at(2).index2 == 13u);
+        for(const auto& c : contacts)
+        {
+            BOOST_TEST(c.frequency == 0.75);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ensemble_go_contact)
+{
+    const auto compact  = make_model("compact",  1.0);
+    const auto extended = make_model("extended", 10.0);
+    const std::vector<std::reference_wrapper<const jarngreipr::CGGroup<double>>>
+        models{std::cref(compact), std::cref(extended), std::cref(compact),
+               std::cref(compact)};
+
+    const jarngreipr::EnsembleGoContact<double> gen(toml::value{
+        {"coef_contact", 0.4}, {"contact_threshold", 5.0}, {"min_separation", 2}
+    }, 2);
+
+    // coefficients are weighted by the frequency. v0 is the distance in the
+    // reference group.
+    jarngreipr::ForceField<double> ff;
+    gen.generate(ff, compact, models);
+    BOOST_TEST_REQUIRE(ff.local().size() == 1u);
+    const auto& params = ff.local().front().parameters;
+    BOOST_TEST_REQUIRE(params.size() == 3u);
+
+    const std::size_t expected[3][2] = {{10, 12}, {10, 13}, {11, 13}};
+    for(std::size_t i=0; i<params.size(); ++i)
+    {
+        BOOST_TEST(params.index(i, 0) == expected[i][0]);
+        BOOST_TEST(params.index(i, 1) == expected[i][1]);
+        BOOST_TEST(params.real(i, 0) == double(expected[i][1] - expected[i][0]),
+                   boost::test_tools::tolerance(1e-12));
+        BOOST_TEST(params.real(i, 1) == -0.4 * 0.75,
+                   boost::test_tools::tolerance(1e-12));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ensemble_go_contact_without_contacts)
+{
+    const auto extended = make_model("extended", 10.0);
+    const std::vector<std::reference_wrapper<const jarngreipr::CGGroup<double>>>
+        models{std::cref(extended), std::cref(extended)};
+
+    const jarngreipr::EnsembleGoContact<double> gen(toml::value{
+        {"coef_contact", 0.4}, {"contact_threshold", 5.0}, {"min_separation", 2}
+    }, 1);
+
+    // no contact is found, so no comment is left for the later parameters.
+    jarngreipr::ForceField<double> ff;
+    gen.generate(ff, extended, models);
+    BOOST_TEST_REQUIRE(ff.local().size() == 1u);
+    const auto& params = ff.local().front().parameters;
+    BOOST_TEST(params.size() == 0u);
+    BOOST_TEST(params.comments().empty());
+}
@@ -0,0 +1,51 @@
+#define BOOST_TEST_MODULE "test_expand_assembly"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/model/expand_assembly.hpp>
+
+BOOST_AUTO_TEST_CASE(test_expand_assembly_copies)
+{
+    using bead_type       = jarngreipr::CachedBead<double>;
+    using coordinate_type = bead_type::coordinate_type;
+    using operator_type   = jarngreipr::SymmetryOperator<double>;
+
+    // a unit of 1 chain that has 2 beads, indices 5 and 6.
+    jarngreipr::CGChain<double> chain("A");
+    for(std::size_t i=0; i<2; ++i)
+    {
+        const coordinate_type pos(1.0 + i, 2.0, 3.0);
+        chain.push_back(std::make_shared<bead_type>(
+            jarngreipr::CGBeadKind::CarbonAlpha, 5 + i, 100.0, "CA", pos,
+            static_cast<std::int32_t>(i + 1), std::vector<coordinate_type>{pos},
+            std::vector<std::uint8_t>{0}));
+    }
+    chain.at(1)->attribute("flexible_regions") = "";
+    jarngreipr::CGGroup<double> unit("protein");
+    unit.push_back(chain);
+
+    // rotate 180 degrees around z axis and translate along z axis.
+    operator_type rot{{{{{-1.0, 0.0, 0.0}}, {{0.0, -1.0, 0.0}}, {{0.0, 0.0, 1.0}}}},
+                      {{0.0, 0.0, 10.0}}};
+    const auto assembly = jarngreipr::expand_assembly(
+            unit, std::vector<operator_type>{operator_type::identity(), rot});
+
+    BOOST_TEST_REQUIRE(assembly.size() == 2u);
+    BOOST_TEST(assembly.at(0).name() == "A_1");
+    BOOST_TEST(assembly.at(1).name() == "A_2");
+
+    // the identity shares the beads
+    BOOST_TEST(assembly.at(0).at(0) == unit.at(0).at(0));
+
+    const auto& copy = assembly.at(1);
+    BOOST_TEST_REQUIRE(copy.size() == 2u);
+    BOOST_TEST(copy.at(0)->index() == 7u);
+    BOOST_TEST(copy.at(1)->index() == 8u);
+    BOOST_TEST(copy.at(1)->residue_id() == 2);
+    BOOST_TEST(copy.at(1)->has_attribute("flexible_regions"));
+    BOOST_TEST(!copy.at(0)->has_attribute("flexible_regions"));
+
+    const auto p = copy.at(1)->position();
+    BOOST_TEST(p[0] == -2.0);
+    BOOST_TEST(p[1] == -2.0);
+    BOOST_TEST(p[2] == 13.0);
+    BOOST_TEST(copy.at(1)->heavy_positions().at(0)[0] == -2.0);
+}
@@ -0,0 +1,326 @@
+#define BOOST_TEST_MODULE "test_generate_assembly"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/forcefield/generate_assembly.hpp>
+#include <jarngreipr/forcefield/GoContact.hpp>
+#include <jarngreipr/model/CachedBead.hpp>
+#include <algorithm>
+#include <random>
+#include <tuple>
+
+namespace
+{
+using bead_type       = jarngreipr::CachedBead<double>;
+using coordinate_type = bead_type::coordinate_type;
+
+// intra-chain bonds and inter-chain Go contacts, so that both the stamped
+// and the inter-chain parameters are checked.
+class BondAndGoContact final : public jarngreipr::ForceFieldGenerator<double>
+{
+  public:
+    using base_type  = jarngreipr::ForceFieldGenerator<double>;
+    using group_type = base_type::group_type;
+    using chain_type = base_type::chain_type;
+    using value_type = jarngreipr::ForceField<double>::value_type;
+
+    explicit BondAndGoContact(const toml::value& para): go_(para) {}
+
+    jarngreipr::ForceField<double>&
+    generate(jarngreipr::ForceField<double>& out, const group_type& group) const override
+    {
+        auto& params = out.find_or_push_local(value_type{
+            {"interaction", "BondLength"},
+            {"potential",   "Harmonic"},
+            {"topology",    "bond"}
+        }, {"interaction", "potential", "topology"},
+        jarngreipr::ParameterTable<double>(2, {"v0", "k"}));
+
+        for(const auto& chain : group)
+        {
+            for(std::size_t i=1; i<chain.size(); ++i)
+            {
+                params.push_back({chain.at(i-1)->index(), chain.at(i)->index()},
+                    {jarngreipr::distance(chain.at(i-1)->position(),
+                                          chain.at(i)->position()), 10.0});
+            }
+        }
+        return go_.generate(out, group);
+    }
+    jarngreipr::ForceField<double>&
+    generate(jarngreipr::ForceField<double>& out,
+             const std::vector<std::reference_wrapper<const group_type>>& gs
+             ) const override
+    {
+        return go_.generate(out, gs);
+    }
+    bool check_beads_kind(const chain_type&) const override {return true;}
+
+  private:
+    jarngreipr::GoContact<double> go_;
+};
+
+// angle parameters in a table distinguished by "env", like the flexible local
+// angle of AICG2+ that depends on the parameter file.
+class EnvAngle final : public jarngreipr::ForceFieldGenerator<double>
+{
+  public:
+    using base_type  = jarngreipr::ForceFieldGenerator<double>;
+    using group_type = base_type::group_type;
+    using chain_type = base_type::chain_type;
+    using value_type = jarngreipr::ForceField<double>::value_type;
+
+    explicit EnvAngle(const double y): y_(y) {}
+
+    jarngreipr::ForceField<double>&
+    generate(jarngreipr::ForceField<double>& out, const group_type& group) const override
+    {
+        value_type::table_type env;
+        env["y"] = y_;
+        auto& params = out.find_or_push_local(value_type{
+            {"interaction", "BondAngle"},
+            {"potential",   "FlexibleLocalAngle"},
+            {"topology",    "none"},
+            {"env",         env}
+        }, {"interaction", "potential", "topology", "env"},
+        jarngreipr::ParameterTable<double>(3, {"k"}));
+
+        for(const auto& chain : group)
+        {
+            for(std::size_t i=2; i<chain.size(); ++i)
+            {
+                params.push_back({chain.at(i-2)->index(), chain.at(i-1)->index(),
+                                  chain.at(i)->index()}, {y_});
+            }
+        }
+        return out;
+    }
+    jarngreipr::ForceField<double>&
+    generate(jarngreipr::ForceField<double>& out,
+             const std::vector<std::reference_wrapper<const group_type>>&
+             ) const override
+    {
+        return out;
+    }
+    bool check_beads_kind(const chain_type&) const override {return true;}
+
+  private:
+    double y_;
+};
+
+// each table of `lhs` has a table with the same header and parameters in `rhs`.
+void check_same_tables(const jarngreipr::ForceField<double>& lhs,
+                       const jarngreipr::ForceField<double>& rhs)
+{
+    BOOST_TEST_REQUIRE(lhs.local().size() == rhs.local().size());
+    for(const auto& l : lhs.local())
+    {
+        const auto found = std::find_if(rhs.local().begin(), rhs.local().end(),
+            [&](const jarngreipr::ForceField<double>::table_type& r) {
+                return r.header == l.header;
+            });
+        BOOST_TEST_REQUIRE((found != rhs.local().end()));
+
+        const auto& lp = l.parameters;
+        const auto& rp = found->parameters;
+        BOOST_TEST_REQUIRE(lp.size() == rp.size());
+
+        std::vector<std::tuple<std::size_t, std::size_t, std::size_t, double>> ls, rs;
+        for(std::size_t i=0; i<lp.size(); ++i)
+        {
+            ls.emplace_back(lp.index(i, 0), lp.index(i, 1), lp.index(i, 2), lp.real(i, 0));
+            rs.emplace_back(rp.index(i, 0), rp.index(i, 1), rp.index(i, 2), rp.real(i, 0));
+        }
+        std::sort(ls.begin(), ls.end());
+        std::sort(rs.begin(), rs.end());
+        BOOST_TEST((ls == rs));
+    }
+    return;
+}
+
+// {potential, indices, reals} of all the local parameters, sorted.
+using parameter_type = std::tuple<std::string, std::vector<std::size_t>,
+                                  std::vector<double>>;
+std::vector<parameter_type>
+sorted_parameters(const jarngreipr::ForceField<double>& ff)
+{
+    std::vector<parameter_type> retval;
+    for(const auto& table : ff.local())
+    {
+        const auto name = toml::find<std::string>(table.header, "potential");
+        const auto& params = table.parameters;
+        for(std::size_t i=0; i<params.size(); ++i)
+        {
+            parameter_type p(name, {}, {});
+            for(std::size_t k=0; k<params.arity(); ++k)
+            {
+                std::get<1>(p).push_back(params.index(i, k));
+            }
+            for(std::size_t k=0; k<params.real_keys().size(); ++k)
+            {
+                std::get<2>(p).push_back(params.real(i, k));
+            }
+            retval.push_back(std::move(p));
+        }
+    }
+    std::sort(retval.begin(), retval.end());
+    return retval;
+}
+
+bool has_comment(const jarngreipr::ForceField<double>& ff, const std::string& c)
+{
+    for(const auto& table : ff.local())
+    {
+        for(const auto& comment : table.parameters.comments())
+        {
+            if(comment.second == c) {return true;}
+        }
+    }
+    return false;
+}
+
+// chain A has 12 beads in a random walk. chain B is A rotated by 90 degrees
+// around z axis and moved, so that they have contacts.
+jarngreipr::CGGroup<double> make_dimer(const double displacement)
+{
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<double> uni(-1.0, 1.0);
+
+    std::vector<coordinate_type> walk(1, coordinate_type(0.0, 0.0, 0.0));
+    while(walk.size() < 12)
+    {
+        const coordinate_type dir(uni(mt), uni(mt), uni(mt));
+        const auto len = mjolnir::math::length(dir);
+        if(len < 0.1 || 1.0 < len) {continue;}
+        walk.push_back(walk.back() + dir * (3.8 / len));
+    }
+
+    jarngreipr::CGChain<double> a("A"), b("B");
+    for(std::size_t i=0; i<walk.size(); ++i)
+    {
+        const auto& p = walk.at(i);
+        const coordinate_type off(0.7, 0.0, 0.0);
+        a.push_back(std::make_shared<bead_type>(
+            jarngreipr::CGBeadKind::CarbonAlpha, i, 100.0, "CA", p,
+            static_cast<std::int32_t>(i + 1), std::vector<coordinate_type>{p, p + off},
+            std::vector<std::uint8_t>{0, 1}));
+
+        // `displacement` moves a bead of B to break the symmetry
+        const coordinate_type q(-p[1] + 6.0 + (i == 5 ? displacement : 0.0),
+                                p[0], p[2] + 1.0);
+        const coordinate_type off_q(0.0, 0.7, 0.0); // `off` rotated
+        b.push_back(std::make_shared<bead_type>(
+            jarngreipr::CGBeadKind::CarbonAlpha, walk.size() + i, 100.0, "CA", q,
+            static_cast<std::int32_t>(i + 1), std::vector<coordinate_type>{q, q + off_q},
+            std::vector<std::uint8_t>{0, 1}));
+    }
+
+    jarngreipr::CGGroup<double> group("dimer");
+    group.push_back(a);
+    group.push_back(b);
+    return group;
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_generate_replicated_same_as_generate)
+{
+    const BondAndGoContact gen(toml::value{
+        {"coef_contact", 0.3}, {"contact_threshold", 6.5}
+    });
+    const auto group = make_dimer(0.0);
+
+    jarngreipr::ForceField<double> full, replicated;
+    gen.generate(full, group);
+    jarngreipr::generate_replicated(gen, replicated, group, 1e-2);
+
+    // B is stamped from A
+    BOOST_TEST(has_comment(replicated, " chain B, the same as chain A"));
+
+    const auto expected = sorted_parameters(full);
+    const auto actual   = sorted_parameters(replicated);
+    BOOST_TEST_REQUIRE(actual.size() == expected.size());
+
+    std::size_t num_contacts = 0;
+    for(std::size_t i=0; i<expected.size(); ++i)
+    {
+        BOOST_TEST(std::get<0>(actual.at(i)) == std::get<0>(expected.at(i)));
+        BOOST_TEST(std::get<1>(actual.at(i)) == std::get<1>(expected.at(i)),
+                   boost::test_tools::per_element());
+        BOOST_TEST_REQUIRE(std::get<2>(actual.at(i)).size() ==
+                           std::get<2>(expected.at(i)).size());
+        for(std::size_t k=0; k<std::get<2>(expected.at(i)).size(); ++k)
+        {
+            // stamped distances are calculated from the coordinates of A
+            BOOST_TEST(std::get<2>(actual.at(i)).at(k) ==
+                       std::get<2>(expected.at(i)).at(k),
+                       boost::test_tools::tolerance(1e-8));
+        }
+        if(std::get<0>(expected.at(i)) == "GoContact") {++num_contacts;}
+    }
+    BOOST_TEST(num_contacts != 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_generate_replicated_fallback)
+{
+    const BondAndGoContact gen(toml::value{
+        {"coef_contact", 0.3}, {"contact_threshold", 6.5}
+    });
+    // B is not a rigid copy of A within the tolerance
+    const auto group = make_dimer(0.5);
+
+    jarngreipr::ForceField<double> full, replicated;
+    gen.generate(full, group);
+    jarngreipr::generate_replicated(gen, replicated, group, 1e-2);
+
+    BOOST_TEST(!has_comment(replicated, " chain B, the same as chain A"));
+
+    // the same as gen.generate, including the order
+    BOOST_TEST_REQUIRE(replicated.local().size() == full.local().size());
+    for(std::size_t t=0; t<full.local().size(); ++t)
+    {
+        const auto& lhs = full.local().at(t).parameters;
+        const auto& rhs = replicated.local().at(t).parameters;
+        BOOST_TEST_REQUIRE(lhs.size() == rhs.size());
+        for(std::size_t i=0; i<lhs.size(); ++i)
+        {
+            BOOST_TEST(lhs.index(i, 0) == rhs.index(i, 0));
+            BOOST_TEST(lhs.index(i, 1) == rhs.index(i, 1));
+            BOOST_TEST(lhs.real(i, 0)  == rhs.real(i, 0));
+            BOOST_TEST(lhs.real(i, 1)  == rhs.real(i, 1));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_generate_replicated_keeps_env)
+{
+    const auto group = make_dimer(0.0);
+
+    // `out` already has a table of the same potential with another env
+    jarngreipr::ForceField<double> full, replicated;
+    EnvAngle(1.0).generate(full,       group);
+    EnvAngle(1.0).generate(replicated, group);
+
+    const EnvAngle gen(2.0);
+    gen.generate(full, group);
+    jarngreipr::generate_replicated(gen, replicated, group, 1e-2);
+
+    BOOST_TEST(has_comment(replicated, " chain B, the same as chain A"));
+    BOOST_TEST(full.local().size() == 2u);
+    check_same_tables(full, replicated);
+}
+
+BOOST_AUTO_TEST_CASE(test_generate_assembly_keeps_env)
+{
+    // B follows A, as the copies made by expand_assembly
+    const auto group = make_dimer(0.0);
+
+    jarngreipr::ForceField<double> full, assembly;
+    EnvAngle(1.0).generate(full,     group);
+    EnvAngle(1.0).generate(assembly, group);
+
+    const EnvAngle gen(2.0);
+    gen.generate(full, group);
+    jarngreipr::generate_assembly(gen, assembly, group, 2);
+
+    BOOST_TEST(has_comment(assembly, " copy 2 of dimer, the same as copy 1"));
+    BOOST_TEST(full.local().size() == 2u);
+    check_same_tables(full, assembly);
+}
@@ -0,0 +1,152 @@
+#define BOOST_TEST_MODULE "test_gzip"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/util/gzip.hpp>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <cstdio>
+
+namespace
+{
+std::string make_text(const std::string& prefix, const std::size_t lines)
+{
+    std::ostringstream oss;
+    for(std::size_t i=0; i<lines; ++i)
+    {
+        oss << prefix << ' ' << i << " 1.000 2.000 3.000\n";
+    }
+    return oss.str();
+}
+
+// each string is written as a gzip member, like bgzip does.
+void write_members(const std::string& fname, const std::vector<std::string>& members)
+{
+    std::remove(fname.c_str());
+    for(const auto& member : members)
+    {
+        gzFile file = gzopen(fname.c_str(), "ab");
+        BOOST_TEST_REQUIRE(file != nullptr);
+        BOOST_TEST_REQUIRE(gzwrite(file, member.data(),
+                    static_cast<unsigned>(member.size())) == int(member.size()));
+        BOOST_TEST_REQUIRE(gzclose(file) == Z_OK);
+    }
+}
+
+std::string read_file(const std::string& fname)
+{
+    std::ifstream ifs(fname, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs),
+                       std::istreambuf_iterator<char>());
+}
+void write_file(const std::string& fname, const std::string& content)
+{
+    std::ofstream ofs(fname, std::ios::binary);
+    ofs.write(content.data(), content.size());
+}
+std::string read_all(std::istream& is)
+{
+    return std::string(std::istreambuf_iterator<char>(is),
+                       std::istreambuf_iterator<char>());
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_gunzip_multi_member)
+{
+    const std::string fname("test_gzip_multi.gz");
+    const std::string first  = make_text("first",  10000);
+    const std::string second = make_text("second", 10);
+    write_members(fname, {first, second});
+
+    const std::string compressed = read_file(fname);
+    BOOST_TEST(jarngreipr::is_gzip(compressed.data(), compressed.size()));
+
+    // ISIZE of the last member is smaller than the whole data
+    std::vector<char> out;
+    BOOST_TEST_REQUIRE(jarngreipr::gunzip(compressed.data(), compressed.size(), out));
+    BOOST_TEST(std::string(out.begin(), out.end()) == first + second);
+
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_gunzip_broken)
+{
+    const std::string fname("test_gzip_broken.gz");
+    write_members(fname, {make_text("line", 10000)});
+    const std::string compressed = read_file(fname);
+
+    for(const std::size_t len : {std::size_t(1), std::size_t(10),
+            compressed.size() / 2, compressed.size() - 1})
+    {
+        std::vector<char> out;
+        BOOST_TEST(!jarngreipr::gunzip(compressed.data(), len, out));
+    }
+
+    // a broken ISIZE (4 GiB - 1) does not reserve gigabytes
+    std::string broken_size = compressed;
+    for(std::size_t i=1; i<=4; ++i)
+    {
+        broken_size.at(broken_size.size() - i) = '\xff';
+    }
+    std::vector<char> out;
+    BOOST_TEST(!jarngreipr::gunzip(broken_size.data(), broken_size.size(), out));
+    BOOST_TEST(out.capacity() <= broken_size.size() * 1032);
+
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_igzstream_multi_member_and_rewind)
+{
+    const std::string fname("test_igzstream_multi.gz");
+    const std::string first  = make_text("first",  10000);
+    const std::string second = make_text("second", 10000);
+    write_members(fname, {first, second});
+
+    jarngreipr::igzstream ifs(fname);
+    BOOST_TEST_REQUIRE(ifs.is_open());
+    BOOST_TEST(read_all(ifs) == first + second);
+
+    // rewind after reading the whole file
+    ifs.clear();
+    ifs.seekg(0);
+    BOOST_TEST(ifs.good());
+    std::string line;
+    BOOST_TEST(static_cast<bool>(std::getline(ifs, line)));
+    BOOST_TEST(line == "first 0 1.000 2.000 3.000");
+    BOOST_TEST(read_all(ifs) == (first + second).substr(line.size() + 1));
+
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_igzstream_uncompressed)
+{
+    const std::string fname("test_igzstream_plain.txt");
+    const std::string content = make_text("plain", 100);
+    write_file(fname, content);
+
+    jarngreipr::igzstream ifs(fname);
+    BOOST_TEST_REQUIRE(ifs.is_open());
+    BOOST_TEST(read_all(ifs) == content);
+
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_igzstream_truncated)
+{
+    const std::string fname("test_igzstream_truncated.gz");
+    const std::string content = make_text("line", 10000);
+    write_members(fname, {content});
+    const std::string compressed = read_file(fname);
+    write_file(fname, compressed.substr(0, compressed.size() / 2));
+
+    // the data before the cut is read, and then it fails instead of EOF
+    jarngreipr::igzstream ifs(fname);
+    BOOST_TEST_REQUIRE(ifs.is_open());
+    std::string line;
+    std::size_t num_lines = 0;
+    while(std::getline(ifs, line)) {++num_lines;}
+    BOOST_TEST(ifs.bad());
+    BOOST_TEST(0u < num_lines);
+    BOOST_TEST(num_lines < 10000u);
+
+    std::remove(fname.c_str());
+}
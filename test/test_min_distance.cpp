@@ -0,0 +1,114 @@
+#define BOOST_TEST_MODULE "test_min_distance"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/geometry/min_distance.hpp>
+#include <random>
+#include <cmath>
+
+// This file is compiled with the default flags, with JARNGREIPR_WITHOUT_SIMD,
+// and with -mavx if the host runs AVX (see CMakeLists.txt). In every build,
+// any_pair_within should be the same as the scalar loop.
+
+namespace
+{
+using coordinate_type = mjolnir::math::Vector<double, 3>;
+
+const char* kernel_name()
+{
+#if defined(JARNGREIPR_WITHOUT_SIMD)
+    return "scalar";
+#elif defined(__AVX__)
+    return "AVX";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+// `n` points that are far from the origin.
+std::vector<coordinate_type> far_points(std::mt19937& mt, const std::size_t n)
+{
+    std::uniform_real_distribution<double> uni(-5.0, 5.0);
+    std::vector<coordinate_type> ps;
+    for(std::size_t i=0; i<n; ++i)
+    {
+        ps.emplace_back(100.0 + uni(mt), uni(mt), uni(mt));
+    }
+    return ps;
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_any_pair_within_at_threshold)
+{
+    BOOST_TEST_MESSAGE("kernel: " << kernel_name());
+    std::mt19937 mt(123456789);
+
+    // (3, 4, 12) has the squared length 169 exactly. The pair is within the
+    // threshold only if the threshold is larger than it. It is placed at each
+    // position of arrays of various lengths, so it falls in every SIMD lane
+    // and in the scalar remainder.
+    const coordinate_type origin(1.0, 2.0, -3.0);
+    const coordinate_type close = origin + coordinate_type(3.0, 4.0, 12.0);
+    const double thresholds[] = {
+        std::nextafter(169.0, 0.0), 169.0, std::nextafter(169.0, 1000.0)
+    };
+    for(std::size_t lsize=1; lsize<=5; ++lsize)
+    {
+        for(std::size_t rsize=1; rsize<=9; ++rsize)
+        {
+            for(std::size_t li=0; li<lsize; ++li)
+            {
+                for(std::size_t ri=0; ri<rsize; ++ri)
+                {
+                    auto lhs = far_points(mt, lsize);
+                    auto rhs = far_points(mt, rsize);
+                    for(auto& p : lhs) {p[0] = -p[0];} // lhs and rhs are far
+                    lhs.at(li) = origin;
+                    rhs.at(ri) = close;
+
+                    for(const double th2 : thresholds)
+                    {
+                        const bool expected = jarngreipr::detail::any_pair_within_scalar(
+                            lhs.data(), lhs.size(), rhs.data(), rhs.size(), th2);
+                        BOOST_TEST(expected == (169.0 < th2));
+                        BOOST_TEST(jarngreipr::any_pair_within(lhs, rhs, th2) == expected);
+                        BOOST_TEST(jarngreipr::any_pair_within(rhs, lhs, th2) == expected);
+                        BOOST_TEST((jarngreipr::min_distance_sq(lhs, rhs) < th2) == expected);
+                    }
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_any_pair_within_random)
+{
+    BOOST_TEST_MESSAGE("kernel: " << kernel_name());
+    std::mt19937 mt(987654321);
+    std::uniform_int_distribution<std::size_t> len(0, 15);
+    std::uniform_real_distribution<double>     uni(-4.0, 4.0);
+    std::uniform_real_distribution<double>     sep(0.0, 16.0);
+
+    std::size_t num_within = 0;
+    for(std::size_t trial=0; trial<10000; ++trial)
+    {
+        const double dx = sep(mt);
+        std::vector<coordinate_type> lhs, rhs;
+        for(std::size_t i=0, n=len(mt); i<n; ++i)
+        {
+            lhs.emplace_back(uni(mt), uni(mt), uni(mt));
+        }
+        for(std::size_t i=0, n=len(mt); i<n; ++i)
+        {
+            rhs.emplace_back(dx + uni(mt), uni(mt), uni(mt));
+        }
+        const double th2 = 6.5 * 6.5;
+        const bool expected = jarngreipr::detail::any_pair_within_scalar(
+            lhs.data(), lhs.size(), rhs.data(), rhs.size(), th2);
+        BOOST_TEST(jarngreipr::any_pair_within(lhs, rhs, th2) == expected);
+        if(expected) {++num_within;}
+    }
+    // both cases are tested
+    BOOST_TEST(num_within != 0u);
+    BOOST_TEST(num_within != 10000u);
+}
@@ -0,0 +1,135 @@
+#define BOOST_TEST_MODULE "test_mmcif_reader"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/mmcif/MMCIFReader.hpp>
+#include <jarngreipr/model/CarbonAlpha.hpp>
+#include <jarngreipr/forcefield/GoContact.hpp>
+#include <fstream>
+#include <cstdio>
+
+BOOST_AUTO_TEST_CASE(test_mmcif_reader)
+{
+    const std::string fname("test_mmcif_reader.cif");
+    {
+        std::ofstream ofs(fname);
+        ofs << "data_TEST\n"
+               "#\n"
+               "_entry.id TEST\n"
+               "#\n"
+               "loop_\n"
+               "_struct_keywords.text\n"
+               ";a text field\n"
+               "with loop_ in it\n"
+               ";\n"
+               "#\n"
+               "loop_\n"
+               "_atom_site.group_PDB\n"
+               "_atom_site.id\n"
+               "_atom_site.type_symbol\n"
+               "_atom_site.label_atom_id\n"
+               "_atom_site.label_alt_id\n"
+               "_atom_site.label_comp_id\n"
+               "_atom_site.label_asym_id\n"
+               "_atom_site.label_seq_id\n"
+               "_atom_site.Cartn_x\n"
+               "_atom_site.Cartn_y\n"
+               "_atom_site.Cartn_z\n"
+               "_atom_site.occupancy\n"
+               "_atom_site.B_iso_or_equiv\n"
+               "_atom_site.pdbx_formal_charge\n"
+               "_atom_site.auth_asym_id\n"
+               "_atom_site.pdbx_PDB_model_num\n"
+               "ATOM   1 C  CA    . ALA A 1  1.000  2.000  3.000 1.00 10.00 ? A  1\n"
+               "ATOM   2 O  \"O5'\" . DA  B 1  4.000  5.000  6.000 1.00 20.00 ? AA 1\n"
+               "HETATM 3 CA CA    . CA  C . 0.000  0.000  0.000 1.00  0.00 2 AA 1\n"
+               "ATOM   4 N  N     . DA  B 2 -1.500 -2.500 -3.500 0.50  ?     ? AA 1\n"
+               "ATOM   5 C  CA    . ALA A 1  1.500  2.000  3.000 1.00 10.00 ? A  2\n"
+               "#\n";
+    }
+
+    jarngreipr::MMCIFReader<double> reader(fname);
+
+    const auto a = reader.read_chain("A");
+    BOOST_TEST(a->atoms_size() == 1u);
+    BOOST_TEST(a->atom_at(0).atom_name    == " CA ");
+    BOOST_TEST(a->atom_at(0).residue_name == "ALA");
+    BOOST_TEST(a->atom_at(0).element      == " C");
+    BOOST_TEST(a->atom_at(0).position[0]  == 1.0);
+    BOOST_TEST(a->atom_at(0).temperature_factor == 10.0);
+
+    const auto a2 = reader.read_chain("A", 2);
+    BOOST_TEST(a2->atoms_size() == 1u);
+    BOOST_TEST(a2->atom_at(0).position[0] == 1.5);
+
+    const auto aa = reader.read_chain("AA");
+    BOOST_TEST(aa->atoms_size() == 2u);
+    BOOST_TEST(aa->residues_size() == 2u);
+    BOOST_TEST(aa->chain_id() == "AA");
+    BOOST_TEST(aa->atom_at(0).atom_name    == " O5'");
+    BOOST_TEST(aa->atom_at(0).residue_name == " DA");
+    BOOST_TEST(aa->atom_at(1).atom_id      == 4);
+    BOOST_TEST(aa->atom_at(1).residue_id   == 2);
+    BOOST_TEST(aa->atom_at(1).position[2]  == -3.5);
+    BOOST_TEST(aa->atom_at(1).occupancy    == 0.5);
+    BOOST_TEST(aa->atom_at(1).temperature_factor == 0.0);
+
+    BOOST_TEST(reader.read_chain("AA") == aa);
+    std::remove(fname.c_str());
+}
+
+// chains that have multi-letter IDs with the same first letter are different
+// chains in the coarse-grained model.
+BOOST_AUTO_TEST_CASE(test_mmcif_multi_letter_chain_contacts)
+{
+    const std::string fname("test_mmcif_multi_letter_chain.cif");
+    {
+        std::ofstream ofs(fname);
+        ofs << "data_TEST\n"
+               "loop_\n"
+               "_atom_site.group_PDB\n"
+               "_atom_site.id\n"
+               "_atom_site.type_symbol\n"
+               "_atom_site.label_atom_id\n"
+               "_atom_site.label_comp_id\n"
+               "_atom_site.label_asym_id\n"
+               "_atom_site.label_seq_id\n"
+               "_atom_site.Cartn_x\n"
+               "_atom_site.Cartn_y\n"
+               "_atom_site.Cartn_z\n"
+               "ATOM 1 C CA ALA AA 1 0.000 0.000 0.000\n"
+               "ATOM 2 C CA ALA AA 2 3.800 0.000 0.000\n"
+               "ATOM 3 C CA ALA AA 3 7.600 0.000 0.000\n"
+               "ATOM 4 C CA ALA AB 1 0.000 5.000 0.000\n"
+               "ATOM 5 C CA ALA AB 2 3.800 5.000 0.000\n"
+               "ATOM 6 C CA ALA AB 3 7.600 5.000 0.000\n"
+               "#\n";
+    }
+    jarngreipr::MMCIFReader<double> reader(fname);
+    toml::table masses;
+    masses["ALA"] = 71.0;
+    toml::table mass;
+    mass["AICG2+"] = masses;
+    const jarngreipr::CarbonAlphaGenerator<double> model{toml::value(mass)};
+
+    jarngreipr::CGGroup<double> aa("aa"), ab("ab");
+    aa.push_back(model.generate(reader.read_chain("AA"), 0));
+    ab.push_back(model.generate(reader.read_chain("AB"), 3));
+    BOOST_TEST(aa.at(0).name() == "AA");
+    BOOST_TEST(ab.at(0).name() == "AB");
+
+    const jarngreipr::GoContact<double> gen(toml::value{
+        {"coef_contact", 0.3}, {"contact_threshold", 6.5}
+    });
+    jarngreipr::ForceField<double> ff;
+    gen.generate(ff, std::vector<std::reference_wrapper<
+        const jarngreipr::CGGroup<double>>>{std::cref(aa), std::cref(ab)});
+
+    BOOST_TEST_REQUIRE(ff.local().size() == 1u);
+    const auto& params = ff.local().front().parameters;
+    BOOST_TEST(params.size() != 0u);
+    for(std::size_t i=0; i<params.size(); ++i)
+    {
+        BOOST_TEST(params.index(i, 0) <  3u);
+        BOOST_TEST(params.index(i, 1) >= 3u);
+    }
+    std::remove(fname.c_str());
+}
@@ -0,0 +1,59 @@
+#define BOOST_TEST_MODULE "test_parse_number"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/util/parse_number.hpp>
+#include <random>
+#include <cstdio>
+
+template<typename T>
+bool parse_int(const std::string& str, T& value)
+{
+    return jarngreipr::parse_integer(str.data(), str.data() + str.size(), value);
+}
+template<typename T>
+bool parse_real(const std::string& str, T& value)
+{
+    return jarngreipr::parse_real(str.data(), str.data() + str.size(), value);
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_integer)
+{
+    std::int32_t i = 0;
+    BOOST_TEST(parse_int("    1", i)); BOOST_TEST(i ==  1);
+    BOOST_TEST(parse_int("  -42", i)); BOOST_TEST(i == -42);
+    BOOST_TEST(parse_int(" 12A ", i)); BOOST_TEST(i ==  12);
+    BOOST_TEST(parse_int("2147483647",  i)); BOOST_TEST(i == 2147483647);
+    BOOST_TEST(parse_int("-2147483648", i));
+    BOOST_TEST(i == std::numeric_limits<std::int32_t>::min());
+
+    BOOST_TEST(!parse_int("2147483648", i));
+    BOOST_TEST(!parse_int("    ", i));
+    BOOST_TEST(!parse_int("  - 1", i));
+    BOOST_TEST(!parse_int("A1", i));
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_real)
+{
+    double d = 0.0;
+    BOOST_TEST(parse_real("  -1.500", d)); BOOST_TEST(d == -1.5);
+    BOOST_TEST(parse_real("   1.0e2", d)); BOOST_TEST(d == 100.0);
+    BOOST_TEST(parse_real("      .5", d)); BOOST_TEST(d == 0.5);
+    BOOST_TEST(!parse_real("        ", d));
+    BOOST_TEST(!parse_real("   -.   ", d));
+
+    // the fast path should give the same value as std::stod/stof.
+    std::mt19937 rng(123456789);
+    std::uniform_real_distribution<double> dist(-9999.0, 9999.0);
+    char buf[32];
+    for(std::size_t i=0; i<100000; ++i)
+    {
+        std::snprintf(buf, sizeof(buf), "%8.3f", dist(rng));
+        const std::string str(buf);
+
+        double dv = 0.0;
+        float  fv = 0.0f;
+        BOOST_TEST(parse_real(str, dv));
+        BOOST_TEST(parse_real(str, fv));
+        BOOST_TEST(dv == std::stod(str));
+        BOOST_TEST(fv == std::stof(str));
+    }
+}
@@ -243,3 +243,27 @@ BOOST_AUTO_TEST_CASE(test_parse_range_chains)
         BOOST_TEST(range.at(3) == "F");
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_parse_range_multi_letter_chains)
+{
+    {
+        const auto range = jarngreipr::parse_chain_range("A"_str);
+        BOOST_TEST(range.size() == 1u);
+        BOOST_TEST(range.at(0) == "A");
+    }
+    {
+        const auto range = jarngreipr::parse_chain_range(" AB "_str);
+        BOOST_TEST(range.size() == 1u);
+        BOOST_TEST(range.at(0) == "AB");
+    }
+    {
+        const auto range = jarngreipr::parse_chain_range("A1"_str);
+        BOOST_TEST(range.size() == 1u);
+        BOOST_TEST(range.at(0) == "A1");
+    }
+    {
+        // ranges are defined only for 1-letter IDs
+        const auto range = jarngreipr::parse_chain_range("AA:AB"_str);
+        BOOST_TEST(range.empty());
+    }
+}
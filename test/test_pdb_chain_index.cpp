@@ -0,0 +1,44 @@
+#define BOOST_TEST_MODULE "test_pdb_chain_index"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/pdb/PDBChainIndex.hpp>
+#include <string>
+
+BOOST_AUTO_TEST_CASE(test_pdb_chain_index)
+{
+    const std::string pdb(
+        "HEADER    TEST\n"
+        "MODEL        1\n"
+        "ATOM      1  CA  ALA A   1       0.000   0.000   0.000  1.00  0.00           C\n"
+        "ATOM      2  CA  ALA A   2       3.800   0.000   0.000  1.00  0.00           C\n"
+        "TER\n"
+        "ATOM      3  CA  GLY B   1       0.000   3.800   0.000  1.00  0.00           C\n"
+        "TER\n"
+        "ENDMDL\n"
+        "MODEL        2\n"
+        "ATOM      1  CA  ALA A   1       1.000   0.000   0.000  1.00  0.00           C\n"
+        "ATOM      2  CA  ALA A   2       4.800   0.000   0.000  1.00  0.00           C\n"
+        "ENDMDL\n"
+        "END\n");
+
+    const jarngreipr::PDBChainIndex index(pdb.data(), pdb.data() + pdb.size());
+    BOOST_TEST(index.records().size() == 3u);
+
+    const auto a1 = index.find('A', 1);
+    const auto b1 = index.find('B', 1);
+    const auto a2 = index.find('A', 2);
+    BOOST_TEST_REQUIRE(a1 != nullptr);
+    BOOST_TEST_REQUIRE(b1 != nullptr);
+    BOOST_TEST_REQUIRE(a2 != nullptr);
+    BOOST_TEST(index.find('B', 2) == nullptr);
+    BOOST_TEST(index.find('C')    == nullptr);
+    BOOST_TEST(index.find('A')    == a1);
+
+    BOOST_TEST(a1->line == 3u);
+    BOOST_TEST(b1->line == 6u);
+    BOOST_TEST(a2->line == 10u);
+
+    const std::string block = pdb.substr(a1->first, a1->last - a1->first);
+    BOOST_TEST(block.substr(0, 6) == "ATOM  ");
+    BOOST_TEST(std::count(block.begin(), block.end(), '\n') == 2);
+    BOOST_TEST(pdb.substr(b1->last, 3) == "TER");
+}
@@ -0,0 +1,139 @@
+#define BOOST_TEST_MODULE "test_pdb_reader"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/pdb/PDBReader.hpp>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstdio>
+
+BOOST_AUTO_TEST_CASE(test_pdb_reader_biomt_chain_list)
+{
+    const std::string fname("test_pdb_reader_biomt.pdb");
+    {
+        std::ofstream ofs(fname);
+        ofs << "REMARK 350 BIOMOLECULE: 1\n"
+               "REMARK 350 APPLY THE FOLLOWING TO CHAINS: A, B,\n"
+               "REMARK 350                    AND CHAINS: C\n"
+               "REMARK 350   BIOMT1   1  1.000000  0.000000  0.000000        0.00000\n"
+               "REMARK 350   BIOMT2   1  0.000000  1.000000  0.000000        0.00000\n"
+               "REMARK 350   BIOMT3   1  0.000000  0.000000  1.000000        0.00000\n"
+               "REMARK 350   BIOMT1   2 -1.000000  0.000000  0.000000        0.00000\n"
+               "REMARK 350   BIOMT2   2  0.000000 -1.000000  0.000000        0.00000\n"
+               "REMARK 350   BIOMT3   2  0.000000  0.000000  1.000000       10.00000\n"
+               "REMARK 350 APPLY THE FOLLOWING TO CHAINS: D\n"
+               "REMARK 350   BIOMT1   1  1.000000  0.000000  0.000000        0.00000\n"
+               "REMARK 350   BIOMT2   1  0.000000  1.000000  0.000000        0.00000\n"
+               "REMARK 350   BIOMT3   1  0.000000  0.000000  1.000000        0.00000\n"
+               "REMARK 350 BIOMOLECULE: 2\n"
+               "REMARK 350 APPLY THE FOLLOWING TO CHAINS: A\n"
+               "REMARK 350   BIOMT1   1  1.000000  0.000000  0.000000       10.00000\n"
+               "REMARK 350   BIOMT2   1  0.000000  1.000000  0.000000        0.00000\n"
+               "REMARK 350   BIOMT3   1  0.000000  0.000000  1.000000        0.00000\n"
+               "ATOM      1  CA  ALA A   1       0.000   0.000   0.000  1.00  0.00           C\n"
+               "ATOM      2  CA  ALA B   1       3.800   0.000   0.000  1.00  0.00           C\n"
+               "ATOM      3  CA  ALA C   1       0.000   3.800   0.000  1.00  0.00           C\n"
+               "ATOM      4  CA  ALA D   1       0.000   0.000   3.800  1.00  0.00           C\n"
+               "END\n";
+    }
+    jarngreipr::PDBReader<double> reader(fname);
+
+    // A and C are in the first list, with 2 operators
+    const auto ac = reader.biomt(1, {"A", "C"});
+    BOOST_TEST_REQUIRE(ac.size() == 2u);
+    BOOST_TEST(ac.at(0).is_identity());
+    BOOST_TEST(ac.at(1).rotation[0][0] == -1.0);
+    BOOST_TEST(ac.at(1).rotation[1][1] == -1.0);
+    BOOST_TEST(ac.at(1).rotation[2][2] ==  1.0);
+    BOOST_TEST(ac.at(1).translation[2] == 10.0);
+
+    // D has its own operator
+    const auto d = reader.biomt(1, {"D"});
+    BOOST_TEST_REQUIRE(d.size() == 1u);
+    BOOST_TEST(d.at(0).is_identity());
+
+    const auto a2 = reader.biomt(2, {"A"});
+    BOOST_TEST_REQUIRE(a2.size() == 1u);
+    BOOST_TEST(a2.at(0).translation[0] == 10.0);
+
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_pdb_reader_chunked_same_as_serial)
+{
+    // 4 atoms per residue with ANISOU records and altlocs scattered, so that
+    // residues and altlocs are split at the chunk boundaries. The chain is
+    // far larger than a chunk (64 KiB).
+    const std::string fname("test_pdb_reader_chunked.pdb");
+    {
+        const char* names[] = {" N  ", " CA ", " C  ", " O  "};
+        std::ofstream ofs(fname);
+        for(std::size_t i=0; i<8000; ++i)
+        {
+            const char altloc = (i % 997 == 0) ? 'A' : ' ';
+            char buf[128];
+            std::snprintf(buf, sizeof(buf), "ATOM  %5d %-4s%c%3s %c%4d%c   "
+                "%8.3f%8.3f%8.3f%6.2f%6.2f          %2s\n",
+                static_cast<int>(i % 100000 + 1), names[i % 4], altloc, "ALA",
+                'A', static_cast<int>(i / 4 + 1), ' ', 0.01 * i, -0.02 * i,
+                0.5 * (i % 7), 1.0, 0.0, names[i % 4][1] == 'C' ? "C" :
+                names[i % 4][1] == 'N' ? "N" : "O");
+            ofs << buf;
+            if(i % 13 == 0)
+            {
+                std::snprintf(buf, sizeof(buf), "ANISOU%5d %-4s%c%3s %c%4d%c "
+                    "%7d%7d%7d%7d%7d%7d\n", static_cast<int>(i % 100000 + 1),
+                    names[i % 4], altloc, "ALA", 'A', static_cast<int>(i / 4 + 1),
+                    ' ', 1, 2, 3, 4, 5, 6);
+                ofs << buf;
+            }
+        }
+        ofs << "TER\nEND\n";
+    }
+
+    // read the chain and collect warnings
+    const auto read = [&fname](const std::size_t num_threads, std::string& warnings) {
+        std::ostringstream oss;
+        auto* const buf = std::cerr.rdbuf(oss.rdbuf());
+        jarngreipr::PDBReader<double> reader(fname, num_threads);
+        const auto chain = reader.read_chain("A");
+        std::cerr.rdbuf(buf);
+        warnings = oss.str();
+        return chain;
+    };
+
+    std::string serial_warnings, chunked_warnings;
+    const auto serial  = read(1, serial_warnings);
+    const auto chunked = read(4, chunked_warnings);
+
+    BOOST_TEST_REQUIRE(serial->atoms_size() == 8000u);
+    BOOST_TEST_REQUIRE(chunked->atoms_size() == serial->atoms_size());
+    for(std::size_t i=0; i<serial->atoms_size(); ++i)
+    {
+        const auto& lhs = serial ->atom_at(i);
+        const auto& rhs = chunked->atom_at(i);
+        BOOST_TEST(lhs.atom_id      == rhs.atom_id);
+        BOOST_TEST(lhs.atom_name    == rhs.atom_name);
+        BOOST_TEST(lhs.altloc       == rhs.altloc);
+        BOOST_TEST(lhs.residue_id   == rhs.residue_id);
+        BOOST_TEST(lhs.residue_name == rhs.residue_name);
+        BOOST_TEST(lhs.element      == rhs.element);
+        BOOST_TEST(lhs.position[0]  == rhs.position[0]);
+        BOOST_TEST(lhs.position[1]  == rhs.position[1]);
+        BOOST_TEST(lhs.position[2]  == rhs.position[2]);
+    }
+
+    BOOST_TEST_REQUIRE(serial->residues_size() == 2000u);
+    BOOST_TEST_REQUIRE(chunked->residues_size() == serial->residues_size());
+    for(std::size_t i=0; i<serial->residues_size(); ++i)
+    {
+        BOOST_TEST(chunked->residue_front_index(i) == serial->residue_front_index(i));
+        BOOST_TEST(chunked->residue_at(i).size() == serial->residue_at(i).size());
+    }
+
+    // warnings contain line numbers, so they are the same only if the lines
+    // are counted correctly in each chunk and reported in the same order.
+    BOOST_TEST(serial_warnings.find("alternative location") != std::string::npos);
+    BOOST_TEST(chunked_warnings == serial_warnings);
+
+    std::remove(fname.c_str());
+}
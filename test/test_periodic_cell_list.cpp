@@ -0,0 +1,50 @@
+#define BOOST_TEST_MODULE "test_periodic_cell_list"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/geometry/PeriodicCellList.hpp>
+#include <random>
+#include <cmath>
+
+BOOST_AUTO_TEST_CASE(test_periodic_cell_list_any_within)
+{
+    using coordinate_type = jarngreipr::PeriodicCellList<double>::coordinate_type;
+
+    std::mt19937 mt(123456789);
+    const coordinate_type lower(-10.0, 0.0, 5.0);
+    const coordinate_type upper( 30.0, 8.0, 45.0); // y has only 1 cell
+
+    const double cutoff = 6.5;
+    for(const std::size_t expected_size : {std::size_t(0), std::size_t(10)})
+    {
+        jarngreipr::PeriodicCellList<double> cell_list(lower, upper, cutoff,
+                                                       expected_size);
+
+        // points are inserted out of the box to check wrapping.
+        std::uniform_real_distribution<double> uni(-50.0, 50.0);
+        std::vector<coordinate_type> points;
+        for(std::size_t i=0; i<200; ++i)
+        {
+            points.emplace_back(uni(mt), uni(mt), uni(mt));
+            cell_list.insert(points.back());
+        }
+        BOOST_TEST(cell_list.size() == 200u);
+
+        for(std::size_t i=0; i<1000; ++i)
+        {
+            const coordinate_type pos(uni(mt), uni(mt), uni(mt));
+            bool within = false;
+            for(const auto& p : points)
+            {
+                double dist_sq = 0.0;
+                for(std::size_t k=0; k<3; ++k)
+                {
+                    const double len = upper[k] - lower[k];
+                    double d = pos[k] - p[k];
+                    d -= len * std::round(d / len);
+                    dist_sq += d * d;
+                }
+                within = within || dist_sq < cutoff * cutoff;
+            }
+            BOOST_TEST(cell_list.any_within(pos) == within);
+        }
+    }
+}
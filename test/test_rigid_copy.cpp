@@ -0,0 +1,36 @@
+#define BOOST_TEST_MODULE "test_rigid_copy"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/geometry/rigid_copy.hpp>
+#include <random>
+
+BOOST_AUTO_TEST_CASE(test_rigid_copy)
+{
+    using coordinate_type = mjolnir::math::Vector<double, 3>;
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<double> uni(-20.0, 20.0);
+
+    std::vector<coordinate_type> points;
+    for(std::size_t i=0; i<100; ++i)
+    {
+        points.emplace_back(uni(mt), uni(mt), uni(mt));
+    }
+
+    // rotate around (1, 1, 1) by 120 degrees, i.e. (x, y, z) -> (z, x, y)
+    std::vector<coordinate_type> rotated, mirrored;
+    for(const auto& p : points)
+    {
+        rotated .emplace_back(p[2] + 10.0, p[0] - 5.0, p[1]);
+        mirrored.emplace_back(-p[0], p[1], p[2]);
+    }
+    BOOST_TEST( jarngreipr::is_rigid_copy(points, rotated,  1e-8));
+    BOOST_TEST(!jarngreipr::is_rigid_copy(points, mirrored, 1e-8));
+
+    auto moved = rotated;
+    moved.at(50)[0] += 0.1;
+    BOOST_TEST(!jarngreipr::is_rigid_copy(points, moved, 1e-2));
+    BOOST_TEST( jarngreipr::is_rigid_copy(points, moved, 1.0));
+
+    moved.pop_back();
+    BOOST_TEST(!jarngreipr::is_rigid_copy(points, moved, 1.0));
+}
@@ -0,0 +1,53 @@
+#define BOOST_TEST_MODULE "test_thread_pool"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/util/thread_pool.hpp>
+#include <jarngreipr/util/parallel_for.hpp>
+#include <stdexcept>
+#include <atomic>
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_visits_each_index_once)
+{
+    jarngreipr::ThreadPool pool(4);
+    BOOST_TEST(pool.size() == 4u);
+
+    // the same workers run many short loops one after another
+    for(std::size_t n=0; n<200; ++n)
+    {
+        std::vector<std::size_t> count(n, 0);
+        pool.parallel_for(0, n, [&](const std::size_t i) {count.at(i) += 1;});
+        for(std::size_t i=0; i<n; ++i)
+        {
+            BOOST_TEST(count.at(i) == 1u);
+        }
+    }
+
+    std::vector<std::size_t> count(100, 0);
+    pool.parallel_for(10, 90, [&](const std::size_t i) {count.at(i) += 1;});
+    for(std::size_t i=0; i<100; ++i)
+    {
+        BOOST_TEST(count.at(i) == ((10 <= i && i < 90) ? 1u : 0u));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_rethrows)
+{
+    for(const std::size_t num_threads : {1u, 2u, 8u})
+    {
+        jarngreipr::ThreadPool pool(num_threads);
+        std::atomic<std::size_t> called(0);
+        BOOST_CHECK_THROW(pool.parallel_for(0, 1000, [&](const std::size_t i) {
+                called += 1;
+                if(i == 10) {throw std::runtime_error("row 10");}
+            }), std::runtime_error);
+        BOOST_TEST(called.load() < 1000u); // the rest is skipped
+
+        // the pool is still usable after an exception
+        std::atomic<std::size_t> sum(0);
+        pool.parallel_for(0, 100, [&](const std::size_t i) {sum += i;});
+        BOOST_TEST(sum.load() == 4950u);
+    }
+
+    BOOST_CHECK_THROW(jarngreipr::parallel_for(4, 0, 100, [](const std::size_t i) {
+            if(i == 99) {throw std::out_of_range("row 99");}
+        }), std::out_of_range);
+}
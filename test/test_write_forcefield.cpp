@@ -0,0 +1,115 @@
+#define BOOST_TEST_MODULE "test_write_forcefield"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/format/write_forcefield.hpp>
+#include <sstream>
+
+// ParameterTable should be written in the same way as toml::value.
+BOOST_AUTO_TEST_CASE(test_write_local_forcefield)
+{
+    using value_type = toml::basic_value<toml::preserve_comments, std::map>;
+    using array_type = value_type::array_type;
+    using table_type = value_type::table_type;
+
+    const value_type header{
+        {"interaction", "DihedralAngle"},
+        {"potential"  , "Gaussian+FlexibleLocalDihedral"},
+        {"topology"   , "none"}
+    };
+
+    jarngreipr::ForceFieldTable<double> typed{header, jarngreipr::ParameterTable<double>(
+        4, {"Gaussian.v0", "Gaussian.k", "FlexibleLocalDihedral.k"},
+           {"FlexibleLocalDihedral.coef"})};
+    value_type tree = header;
+    tree.as_table()["parameters"] = array_type{};
+
+    for(std::size_t i=0; i<12; i+=3)
+    {
+        const double v0 = -3.14 + 0.5 * i;
+        typed.parameters.push_back({i, i+1, i+2, i+3}, {v0, -0.1 * i, 1.0},
+                                   {"ALA-GLY"});
+
+        value_type para = table_type{
+            {"indices", value_type{i, i+1, i+2, i+3}},
+            {"Gaussian", table_type{{"v0", v0}, {"k", -0.1 * i}}},
+            {"FlexibleLocalDihedral", table_type{{"k", 1.0}, {"coef", "ALA-GLY"}}}
+        };
+        if(i == 3)
+        {
+            typed.parameters.add_comment(1, " second");
+            para.comments().push_back(" second");
+        }
+        tree.as_table().at("parameters").as_array().push_back(std::move(para));
+    }
+
+    std::ostringstream expected, written;
+    jarngreipr::write_local_forcefield(expected, tree);
+    jarngreipr::write_local_forcefield(written,  typed);
+    BOOST_TEST(written.str() == expected.str());
+}
+
+// string parameters are escaped in the same way as toml::value.
+BOOST_AUTO_TEST_CASE(test_write_local_forcefield_escape)
+{
+    using value_type = toml::basic_value<toml::preserve_comments, std::map>;
+    using array_type = value_type::array_type;
+    using table_type = value_type::table_type;
+
+    const value_type header{
+        {"interaction", "BondLength"},
+        {"potential"  , "Harmonic"},
+        {"topology"   , "bond"}
+    };
+    jarngreipr::ForceFieldTable<double> typed{header,
+        jarngreipr::ParameterTable<double>(2, {"v0"}, {"name"})};
+    value_type tree = header;
+    tree.as_table()["parameters"] = array_type{};
+
+    const std::string name("\"quoted\" C:\\path");
+    typed.parameters.push_back({0, 1}, {3.8}, {name});
+    tree.as_table().at("parameters").as_array().push_back(table_type{
+        {"indices", value_type{0, 1}}, {"v0", 3.8}, {"name", name}
+    });
+
+    std::ostringstream expected, written;
+    jarngreipr::write_local_forcefield(expected, tree);
+    jarngreipr::write_local_forcefield(written,  typed);
+    BOOST_TEST(written.str() == expected.str());
+    BOOST_TEST(written.str().find("\"\\\"quoted\\\" C:\\\\path\"") !=
+               std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_write_global_forcefield)
+{
+    using value_type = toml::basic_value<toml::preserve_comments, std::map>;
+    using array_type = value_type::array_type;
+    using table_type = value_type::table_type;
+
+    const value_type header{
+        {"interaction", "Pair"},
+        {"potential"  , "ExcludedVolume"},
+        {"ignore", table_type{
+            {"particles_within", table_type{{"bond", 3}, {"contact", 1}}}
+        }},
+        {"spatial_partition", table_type{{"type", "CellList"}, {"margin", 0.5}}},
+        {"epsilon", 0.2}
+    };
+
+    jarngreipr::ForceFieldTable<double> typed{header,
+        jarngreipr::ParameterTable<double>(1, {"radius"})};
+    value_type tree = header;
+    tree.as_table()["parameters"] = array_type{};
+
+    for(std::size_t i=0; i<120; i+=7)
+    {
+        typed.parameters.push_back({i}, {2.0 + 0.01 * i});
+        tree.as_table().at("parameters").as_array().push_back(table_type{
+            {"index", i}, {"radius", 2.0 + 0.01 * i}
+        });
+    }
+    BOOST_TEST(typed.parameters.max_index() == 119u);
+
+    std::ostringstream expected, written;
+    jarngreipr::write_global_forcefield(expected, tree);
+    jarngreipr::write_global_forcefield(written,  typed);
+    BOOST_TEST(written.str() == expected.str());
+}
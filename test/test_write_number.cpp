@@ -0,0 +1,75 @@
+#define BOOST_TEST_MODULE "test_write_number"
+#include <boost/test/included/unit_test.hpp>
+#include <jarngreipr/format/write_number.hpp>
+#include <random>
+#include <limits>
+
+namespace
+{
+std::string fixed(const double x, const int width, const int precision)
+{
+    char buf[512];
+    const auto n = jarngreipr::format_fixed(buf, sizeof(buf), x, width, precision);
+    return std::string(buf, n);
+}
+std::string printf_fixed(const double x, const int width, const int precision)
+{
+    char buf[512];
+    const auto n = std::snprintf(buf, sizeof(buf), "%*.*f", width, precision, x);
+    return std::string(buf, n);
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_format_fixed)
+{
+    const std::vector<double> xs{
+        0.0, -0.0, 1.0, -1.0, 0.5, 1.5, 2.5, -2.5, 0.00005, 0.00015, -0.00005,
+        -0.00001, 1.23445, 1.23455, 3.14159265358979, 999.99995, 99999.99999,
+        1e-300, 1e12, -1e12, 1e20, 1e300, std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::quiet_NaN()
+    };
+    for(const auto x : xs)
+    {
+        for(int precision=0; precision<=6; ++precision)
+        {
+            BOOST_TEST(fixed(x, 9, precision) == printf_fixed(x, 9, precision));
+            BOOST_TEST(fixed(x, 0, precision) == printf_fixed(x, 0, precision));
+        }
+    }
+
+    std::mt19937 mt(123456789);
+    std::uniform_real_distribution<double> uni(-1000.0, 1000.0);
+    std::uniform_int_distribution<int>     digits(0, 10000000);
+    for(std::size_t i=0; i<100000; ++i)
+    {
+        const double x = uni(mt);
+        BOOST_TEST(fixed(x, 9, 4) == printf_fixed(x, 9, 4));
+        BOOST_TEST(fixed(x, 8, 3) == printf_fixed(x, 8, 3));
+
+        // numbers close to a tie, e.g. 12.34565
+        const double y = (digits(mt) + 0.5) * 1e-4 - 500.0;
+        BOOST_TEST(fixed(y, 9, 4) == printf_fixed(y, 9, 4));
+    }
+
+    // truncated in the same way as snprintf
+    char buf[4];
+    BOOST_TEST(jarngreipr::format_fixed(buf, sizeof(buf), 3.14159, 9, 4) == 9u);
+    BOOST_TEST(std::string(buf) == "   ");
+}
+
+BOOST_AUTO_TEST_CASE(test_format_integer)
+{
+    const std::vector<std::int64_t> xs{0, 1, -1, 9, 10, 12345, -12345,
+        std::numeric_limits<std::int64_t>::max(),
+        std::numeric_limits<std::int64_t>::min()};
+    for(const auto x : xs)
+    {
+        for(const int width : {0, 1, 5, 25})
+        {
+            char buf[64], ref[64];
+            const auto n = jarngreipr::format_integer(buf, sizeof(buf), x, width);
+            std::snprintf(ref, sizeof(ref), "%*lld", width, static_cast<long long>(x));
+            BOOST_TEST(std::string(buf, n) == std::string(ref));
+        }
+    }
+}